@@ -6,9 +6,11 @@ extern "C" {
 
 // not interesting for benchmark
 void effi_putchar(char) {}
+void effi_putchars(const char *, size_t) {}
 }
 
 #include <string>
+#include <vector>
 using namespace std::literals;
 
 static void short_buggy_bench(benchmark::State &state) {
@@ -31,3 +33,28 @@ static void long_buggy_bench(benchmark::State &state) {
     for (auto _ : state) print_buggy(init.c_str());
 }
 BENCHMARK(long_buggy_bench);
+
+static std::vector<std::string> many_lines() {
+    std::vector<std::string> lines(1 << 20);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        lines[i] = std::to_string(i) + ' ';
+        while (lines[i].size() < 64) lines[i] += "foo";
+        lines[i].resize(64);
+    }
+    return lines;
+}
+
+static void many_buggy_single_calls_bench(benchmark::State &state) {
+    auto lines = many_lines();
+    for (auto _ : state)
+        for (auto &line : lines) print_buggy(line.c_str());
+}
+BENCHMARK(many_buggy_single_calls_bench);
+
+static void many_buggy_batched_bench(benchmark::State &state) {
+    auto lines = many_lines();
+    std::vector<const char *> strings;
+    for (auto &line : lines) strings.push_back(line.c_str());
+    for (auto _ : state) print_buggy_many(strings.data(), strings.size());
+}
+BENCHMARK(many_buggy_batched_bench);
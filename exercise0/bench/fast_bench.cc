@@ -6,6 +6,7 @@ extern "C" {
 
 // not interesting for benchmark
 void effi_putchar(char) {}
+void effi_putchars(const char *, size_t) {}
 }
 
 
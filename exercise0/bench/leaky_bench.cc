@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "print.h"
+
+
+// not interesting for benchmark
+void effi_putchar(char) {}
+void effi_putchars(const char *, size_t) {}
+}
+
+#include <string>
+using namespace std::literals;
+
+static void short_leaky_bench(benchmark::State &state) {
+    auto init = "zyxwvutsrqponmlkjihgfedcba"s;
+    while (init.size() < (1 << 10)) init += init;
+    init.resize(1 << 10);
+    for (auto _ : state) print_leaky(init.c_str());
+}
+BENCHMARK(short_leaky_bench);
+
+static void medium_leaky_bench(benchmark::State &state) {
+    auto init = "zyxwvutsrqponmlkjihgfedcba"s;
+    while (init.size() < (1 << 20)) init += init;
+    init.resize(1 << 20);
+    for (auto _ : state) print_leaky(init.c_str());
+}
+BENCHMARK(medium_leaky_bench);
+
+static void long_leaky_bench(benchmark::State &state) {
+    auto init = "zyxwvutsrqponmlkjihgfedcba"s;
+    while (init.size() < (1 << 26)) init += init;
+    init.resize(1 << 26);
+    for (auto _ : state) print_leaky(init.c_str());
+}
+BENCHMARK(long_leaky_bench);
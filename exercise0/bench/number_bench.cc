@@ -0,0 +1,28 @@
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "print.h"
+
+
+// not interesting for benchmark
+void effi_putchar(char) {}
+void effi_putchars(const char *, size_t) {}
+}
+
+static void small_number_bench(benchmark::State &state) {
+    for (auto _ : state)
+        for (long long number = 0; number < 100; ++number) print_number(number);
+}
+BENCHMARK(small_number_bench);
+
+static void large_number_bench(benchmark::State &state) {
+    for (auto _ : state)
+        for (long long number = 0; number < 100; ++number) print_number(1000000000000000000LL + number * 12345678901LL);
+}
+BENCHMARK(large_number_bench);
+
+static void negative_number_bench(benchmark::State &state) {
+    for (auto _ : state)
+        for (long long number = 0; number < 100; ++number) print_number(-number * 1234567LL);
+}
+BENCHMARK(negative_number_bench);
@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "print.h"
+#include "effi_sink.h"
+}
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// real output, so effi_putchar keeps its weak default and is never called
+
+enum class backend { fd, writev, uring };
+
+static void sink_bench(benchmark::State &state, backend kind, const char *path) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        state.SkipWithError("cannot open output");
+        return;
+    }
+    effi_fd plain {fd};
+    effi_writev gathered {};
+    gathered.fd = fd;
+    effi_uring uring;
+    for (auto _ : state) {
+        state.PauseTiming();
+        // keep the file from growing by 100 MiB per iteration
+        if (ftruncate(fd, 0) == 0)
+            lseek(fd, 0, SEEK_SET);
+        effi_sink sink;
+        if (kind == backend::fd) {
+            sink = effi_fd_sink(&plain);
+        } else if (kind == backend::writev) {
+            sink = effi_writev_sink(&gathered);
+        } else {
+            effi_uring_open(&uring, fd);
+            sink = effi_uring_sink(&uring);
+        }
+        effi_set_sink(&sink);
+        state.ResumeTiming();
+
+        print_very_slowly('D', 15000);
+        effi_set_sink(nullptr);
+        // waiting for the queued writes is part of the cost
+        if (kind == backend::uring)
+            effi_uring_close(&uring);
+    }
+    close(fd);
+    if (path[0] != '/')
+        unlink(path);
+}
+BENCHMARK_CAPTURE(sink_bench, fd_file, backend::fd, "sink_bench.out");
+BENCHMARK_CAPTURE(sink_bench, writev_file, backend::writev, "sink_bench.out");
+BENCHMARK_CAPTURE(sink_bench, uring_file, backend::uring, "sink_bench.out");
+BENCHMARK_CAPTURE(sink_bench, fd_dev_null, backend::fd, "/dev/null");
+BENCHMARK_CAPTURE(sink_bench, writev_dev_null, backend::writev, "/dev/null");
+BENCHMARK_CAPTURE(sink_bench, uring_dev_null, backend::uring, "/dev/null");
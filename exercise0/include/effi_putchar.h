@@ -6,6 +6,8 @@
 #ifndef INCLUDED___EFFI___P0_HELLO___EFFI_PUTCHAR_H
 #define INCLUDED___EFFI___P0_HELLO___EFFI_PUTCHAR_H
 
+#include <stddef.h>
+
 
 /**
  * \brief external function to allow for testing, basically a putchar forward
@@ -16,4 +18,13 @@
  */
 void effi_putchar(char c);
 
+/**
+ * \brief external function that receives whole spans of buffered output
+ * \param buffer the characters to print
+ * \param length the number of characters in buffer
+ * \attention print.c provides a weak default that forwards every character to effi_putchar,
+ * 		so test hooks on effi_putchar keep working; override it to get bulk output
+ */
+void effi_putchars(const char *buffer, size_t length);
+
 #endif // INCLUDED___EFFI___P0_HELLO___EFFI_PUTCHAR_H
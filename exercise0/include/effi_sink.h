@@ -0,0 +1,202 @@
+/**
+ * \file
+ * declares the output sinks the print functions can write to
+ */
+
+#ifndef INCLUDED___EFFI___P0_HELLO___EFFI_SINK_H
+#define INCLUDED___EFFI___P0_HELLO___EFFI_SINK_H
+
+#include <stddef.h>
+#include <sys/uio.h>
+
+/**
+ * \brief destination for buffered output
+ */
+struct effi_sink {
+    /**
+     * \brief receives a span of output
+     * \param context the context of this sink
+     * \param buffer the characters to print
+     * \param length the number of characters in buffer
+     */
+    void (*write)(void *context, const char *buffer, size_t length);
+
+    /**
+     * \brief state of the sink, passed to write unchanged
+     */
+    void *context;
+
+    /**
+     * \brief called after every flush of the output buffer, may be NULL
+     *
+     * Spans passed to write are only valid until the following flush returns,
+     * sinks that hold on to them instead of copying must write them out here.
+     * \param context the context of this sink
+     */
+    void (*flush)(void *context);
+
+    /**
+     * \brief reports errors of the sink to effi_flush, may be NULL
+     * \param context the context of this sink
+     * \return 0, or an errno value if output was lost since the sink was set up
+     */
+    int (*status)(void *context);
+};
+
+/**
+ * \brief route the output of all print functions to a sink
+ * \param sink the new sink, NULL restores the default that forwards to effi_putchars
+ * \attention pending output is flushed to the previous sink first
+ */
+void effi_set_sink(const struct effi_sink *sink);
+
+/**
+ * \brief growable memory buffer that collects output
+ */
+struct effi_memory_buffer {
+    char *data;
+    size_t length;
+    size_t capacity;
+    //! if not 0, the buffer does not grow beyond limit bytes and fails like a failed allocation instead
+    size_t limit;
+    //! ENOMEM once the buffer could not grow, later output is dropped until it is released
+    int error;
+};
+
+/**
+ * \brief sink that appends to a memory buffer
+ *
+ * effi_flush reports the error of the buffer.
+ * \param buffer an empty or previously used buffer, release it with effi_memory_buffer_release
+ */
+struct effi_sink effi_memory_sink(struct effi_memory_buffer *buffer);
+
+/**
+ * \brief free the storage of a memory buffer and reset it to empty, its limit is kept
+ * \param buffer the buffer
+ */
+void effi_memory_buffer_release(struct effi_memory_buffer *buffer);
+
+/**
+ * \brief file descriptor written with write(2)
+ */
+struct effi_fd {
+    int fd;
+};
+
+/**
+ * \brief sink that writes each flushed span to a file descriptor
+ *
+ * Spans arrive in batches of up to EFFI_OUTPUT_BUFFER_SIZE,
+ * short writes and interrupted calls are retried.
+ * \param fd the file descriptor
+ */
+struct effi_sink effi_fd_sink(struct effi_fd *fd);
+
+/**
+ * \brief statistics of a discarding sink
+ */
+struct effi_counter {
+    size_t bytes;
+    size_t writes;
+};
+
+/**
+ * \brief sink that drops the output and only counts it
+ * \param counter the counter to increase
+ */
+struct effi_sink effi_counting_sink(struct effi_counter *counter);
+
+/**
+ * \brief maximum number of spans a writev sink gathers into one call
+ */
+#define EFFI_WRITEV_MAX_SPANS 64
+
+/**
+ * \brief file descriptor written with writev(2), zero-initialize and set fd
+ */
+struct effi_writev {
+    int fd;
+    struct iovec spans[EFFI_WRITEV_MAX_SPANS];
+    size_t num_spans;
+};
+
+/**
+ * \brief sink that gathers all spans of a flush into a single writev(2)
+ *
+ * A wrapped ring buffer or a large span passed through effi_write then costs one system call.
+ * \param writev the gathering state
+ */
+struct effi_sink effi_writev_sink(struct effi_writev *writev);
+
+/**
+ * \brief number of buffers an io_uring sink keeps in flight
+ */
+#define EFFI_URING_SLOTS 4
+
+/**
+ * \brief size of each buffer of an io_uring sink
+ */
+#define EFFI_URING_SLOT_SIZE (1 << 16)
+
+/**
+ * \brief file descriptor written asynchronously through io_uring
+ *
+ * Output is copied into one of EFFI_URING_SLOTS buffers, full buffers and flushes are
+ * queued as writes without waiting, so printing continues while the kernel writes.
+ * Seekable files get explicit offsets and may have all buffers in flight,
+ * pipes and sockets keep one write in flight to preserve the order.
+ */
+struct effi_uring {
+    int fd;
+    //! -1 if io_uring is unavailable, the sink then behaves like a writev sink
+    int ring_fd;
+    //! next file offset, -1 for unseekable files
+    long long offset;
+
+    void *ring;
+    size_t ring_size;
+    void *sqes;
+    size_t sqes_size;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    void *cqes;
+
+    char *slots;
+    size_t slot_fill[EFFI_URING_SLOTS];
+    long long slot_offset[EFFI_URING_SLOTS];
+    int slot_busy[EFFI_URING_SLOTS];
+    size_t current_slot;
+    size_t in_flight;
+
+    struct effi_writev fallback;
+};
+
+/**
+ * \brief set up an io_uring sink for a file descriptor
+ * \param uring the state to initialize
+ * \param fd the file descriptor, it stays open after effi_uring_close
+ * \return 0 if io_uring is used, -1 if the sink falls back to writev(2)
+ */
+int effi_uring_open(struct effi_uring *uring, int fd);
+
+/**
+ * \brief wait for all queued writes and release the ring
+ *
+ * Seekable files are positioned behind the written data afterwards.
+ * \param uring the state from effi_uring_open
+ * \attention switch the print functions to another sink first, so pending output is flushed
+ */
+void effi_uring_close(struct effi_uring *uring);
+
+/**
+ * \brief sink that writes through io_uring
+ * \param uring the state from effi_uring_open
+ */
+struct effi_sink effi_uring_sink(struct effi_uring *uring);
+
+#endif // INCLUDED___EFFI___P0_HELLO___EFFI_SINK_H
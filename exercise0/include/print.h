@@ -19,6 +19,16 @@ void print_helloworld(void);
  */
 void print_buggy(const char *string);
 
+/**
+ * \brief print_buggy for many strings
+ *
+ * The lines are formatted into the output buffer one after another and streamed to the sink in
+ * chunks of EFFI_OUTPUT_BUFFER_SIZE whenever it fills, the sink is flushed once at the end.
+ * \param strings the input strings
+ * \param n the number of strings
+ */
+void print_buggy_many(const char **strings, size_t n);
+
 /**
  * \brief print the characters in the string sorted by ASCII value
  * \param string the input string
@@ -46,4 +56,26 @@ void print_very_slowly(char c, size_t num_lines);
  */
 void print_number(long long number);
 
+/**
+ * \brief size of the output ring buffer in bytes
+ */
+#define EFFI_OUTPUT_BUFFER_SIZE (1 << 16)
+
+/**
+ * \brief append characters to the output ring buffer
+ *
+ * The buffer is handed to the current sink (see effi_sink.h) whenever it runs full,
+ * spans larger than the buffer are passed through without copying.
+ * \param buffer the characters to print
+ * \param length the number of characters in buffer
+ */
+void effi_write(const char *buffer, size_t length);
+
+/**
+ * \brief hand everything in the output ring buffer to the current sink
+ * \return 0, or an errno value if the sink lost output
+ * \attention all print functions flush before they return
+ */
+int effi_flush(void);
+
 #endif // INCLUDED___EFFI___P0_HELLO___PRINT_H
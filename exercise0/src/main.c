@@ -7,6 +7,10 @@ void effi_putchar(char c) {
     putchar(c);
 }
 
+void effi_putchars(const char *buffer, size_t length) {
+    fwrite(buffer, 1, length, stdout);
+}
+
 int main(void) {
     printf("First step, print hello world:\n");
     print_helloworld();
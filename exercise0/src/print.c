@@ -1,136 +1,317 @@
 // headers from exercise
 #include "print.h"
 #include "effi_putchar.h"
+#include "effi_sink.h"
 
 // headers from standard library
 #include <assert.h>
-#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+
+#define OUTPUT_BUFFER_MASK (EFFI_OUTPUT_BUFFER_SIZE - 1)
+#define NUM_BITS_ULL (CHAR_BIT * sizeof(unsigned long long))
+
+// output ring buffer, output_fill characters starting at output_head are pending
+static char output_buffer[EFFI_OUTPUT_BUFFER_SIZE];
+static size_t output_head = 0;
+static size_t output_fill = 0;
+
+// default bulk hook, weak so tests can keep hooking effi_putchar alone
+__attribute__((weak)) void effi_putchars(const char *buffer, size_t length) {
+    for (size_t i = 0; i < length; ++i)
+        effi_putchar(buffer[i]);
+}
+
+static void putchars_write(void *context, const char *buffer, size_t length) {
+    (void) context;
+    effi_putchars(buffer, length);
+}
+
+static struct effi_sink output_sink = {putchars_write, NULL, NULL, NULL};
+
+void effi_set_sink(const struct effi_sink *sink) {
+    effi_flush();
+    output_sink = sink ? *sink : (struct effi_sink) {putchars_write, NULL, NULL, NULL};
+}
+
+// hands the pending characters to the sink, at most two spans as the buffer may wrap
+static void drain_output(void) {
+    size_t first = EFFI_OUTPUT_BUFFER_SIZE - output_head;
+    if (first > output_fill)
+        first = output_fill;
+    if (first)
+        output_sink.write(output_sink.context, output_buffer + output_head, first);
+    if (output_fill > first)
+        output_sink.write(output_sink.context, output_buffer, output_fill - first);
+    output_head = (output_head + output_fill) & OUTPUT_BUFFER_MASK;
+    output_fill = 0;
+}
+
+int effi_flush(void) {
+    drain_output();
+    if (output_sink.flush)
+        output_sink.flush(output_sink.context);
+    return output_sink.status ? output_sink.status(output_sink.context) : 0;
+}
+
+void effi_write(const char *buffer, size_t length) {
+    if (length >= EFFI_OUTPUT_BUFFER_SIZE) {
+        // copying would only add a pass over the data
+        drain_output();
+        output_sink.write(output_sink.context, buffer, length);
+        if (output_sink.flush)
+            output_sink.flush(output_sink.context);
+        return;
+    }
+    while (length) {
+        size_t tail = (output_head + output_fill) & OUTPUT_BUFFER_MASK;
+        size_t span = EFFI_OUTPUT_BUFFER_SIZE - output_fill;
+        if (span > EFFI_OUTPUT_BUFFER_SIZE - tail)
+            span = EFFI_OUTPUT_BUFFER_SIZE - tail;
+        if (span > length)
+            span = length;
+        memcpy(output_buffer + tail, buffer, span);
+        output_fill += span;
+        buffer += span;
+        length -= span;
+        if (output_fill == EFFI_OUTPUT_BUFFER_SIZE)
+            effi_flush();
+    }
+}
+
+static inline void write_character(char c) {
+    if (output_fill == EFFI_OUTPUT_BUFFER_SIZE)
+        effi_flush();
+    output_buffer[(output_head + output_fill) & OUTPUT_BUFFER_MASK] = c;
+    ++output_fill;
+}
+
+// length and byte sum of a null-terminated string, chars counted with their sign
+struct string_stats {
+    size_t length;
+    long long sum;
+};
+
+static struct string_stats string_stats_scalar(const char *string) {
+    const char *end = string;
+    long long sum = 0;
+    while (*end)
+        sum += *end++;
+    return (struct string_stats) {end - string, sum};
+}
+
+#if defined(__x86_64__)
+// Aligned blocks never cross a page, so reading a whole block past the terminator is safe.
+// psadbw sums unsigned bytes, flipping the top bit turns every char c into c + 128 first.
+
+static struct string_stats string_stats_sse2(const char *string) {
+    const char *end = string;
+    long long sum = 0;
+    for (; (uintptr_t) end & 15; ++end) {
+        if (!*end)
+            return (struct string_stats) {end - string, sum};
+        sum += *end;
+    }
+    const char *blocks_start = end;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi8((char) 0x80);
+    __m128i sums = zero;
+    for (;; end += 16) {
+        __m128i block = _mm_load_si128((const __m128i *) end);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, zero)))
+            break;
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_xor_si128(block, bias), zero));
+    }
+    sum += _mm_cvtsi128_si64(sums) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums));
+    sum -= 128 * (long long) (end - blocks_start);
+    struct string_stats tail = string_stats_scalar(end);
+    return (struct string_stats) {end - string + tail.length, sum + tail.sum};
+}
+
+__attribute__((target("avx2"))) static struct string_stats string_stats_avx2(const char *string) {
+    const char *end = string;
+    long long sum = 0;
+    for (; (uintptr_t) end & 31; ++end) {
+        if (!*end)
+            return (struct string_stats) {end - string, sum};
+        sum += *end;
+    }
+    const char *blocks_start = end;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i bias = _mm256_set1_epi8((char) 0x80);
+    __m256i sums = zero;
+    for (;; end += 32) {
+        __m256i block = _mm256_load_si256((const __m256i *) end);
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, zero)))
+            break;
+        sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_xor_si256(block, bias), zero));
+    }
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+    sum += _mm_cvtsi128_si64(half) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(half, half));
+    sum -= 128 * (long long) (end - blocks_start);
+    struct string_stats tail = string_stats_scalar(end);
+    return (struct string_stats) {end - string + tail.length, sum + tail.sum};
+}
+#endif
+
+static struct string_stats string_stats_resolve(const char *string);
+
+// picks the widest kernel the cpu supports on first use
+static struct string_stats (*string_stats)(const char *string) = string_stats_resolve;
+
+static struct string_stats string_stats_resolve(const char *string) {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    string_stats = __builtin_cpu_supports("avx2") ? string_stats_avx2 : string_stats_sse2;
+#else
+    string_stats = string_stats_scalar;
+#endif
+    return string_stats(string);
+}
+
+// writes count copies of c
+static void write_run(char c, size_t count) {
+    while (count) {
+        if (output_fill == EFFI_OUTPUT_BUFFER_SIZE)
+            effi_flush();
+        size_t tail = (output_head + output_fill) & OUTPUT_BUFFER_MASK;
+        size_t span = EFFI_OUTPUT_BUFFER_SIZE - output_fill;
+        if (span > EFFI_OUTPUT_BUFFER_SIZE - tail)
+            span = EFFI_OUTPUT_BUFFER_SIZE - tail;
+        if (span > count)
+            span = count;
+        memset(output_buffer + tail, c, span);
+        output_fill += span;
+        count -= span;
+    }
+}
+
+static void write_number(long long number);
 
 void print_helloworld(void) {
-    // TODO: empty
+    static const char hello_world[] = "Hello World!\n";
+    effi_write(hello_world, sizeof(hello_world) - 1);
+    effi_flush();
+}
+
+// one line of print_buggy output, left in the output buffer
+static void write_buggy(const char *string) {
+    struct string_stats stats = string_stats(string);
+    long long counter = stats.length;
+    long long sum = stats.sum;
+    effi_write(string, counter);
+
+    effi_write(": ", 2);
+    write_number(sum);
+    write_character('/');
+    write_number(counter);
+    write_character('=');
+    // unsigned division like the size_t sum this started from
+    write_character(counter != 0 ? (size_t) sum / (size_t) counter : '0');
+    write_character('\n');
 }
 
 void print_buggy(const char *string) {
-    long long counter = 0;
-    size_t sum = 0;
-    const char *copy = string;
-    while (copy) {
-        ++counter;
-        sum += *copy++;
-    }
-    while (string)
-        effi_putchar(*string++);
+    write_buggy(string);
+    effi_flush();
+}
 
-    effi_putchar(':');
-    effi_putchar(' ');
-    print_number(sum);
-    effi_putchar('/');
-    print_number(counter);
-    effi_putchar('=');
-    effi_putchar(counter != 0 ? sum / counter : '0');
-    effi_putchar('\n');
+void print_buggy_many(const char **strings, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        write_buggy(strings[i]);
+    effi_flush();
 }
 
 void print_leaky(const char *string) {
     size_t length = strlen(string);
-    char *memory = (char*)malloc(length + 1);
-
-    // try commenting out this line and see what valgrind tells you!
-    memory[length] = 0;
-
-    // insertion sort. No benchmark to save you y'all from the horrors that is qsort
-    for (size_t i = 0; i < length; ++i) {
-        size_t index = 0;
-        for (; index < i && memory[index] < string[i]; ++index)
-            ;
-        memmove(memory + index + 1, memory + index, i - index);
-        memory[index] = string[i];
-    }
+    const unsigned char *bytes = (const unsigned char *) string;
 
-    while (*memory)
-        effi_putchar(*memory++);
-}
+    // four tables so consecutive equal bytes do not wait on each other's increment
+    size_t histograms[4][256] = {{0}};
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        ++histograms[0][bytes[i]];
+        ++histograms[1][bytes[i + 1]];
+        ++histograms[2][bytes[i + 2]];
+        ++histograms[3][bytes[i + 3]];
+    }
+    for (; i < length; ++i)
+        ++histograms[0][bytes[i]];
 
-char *append_character(char *buffer, char c) {
-    size_t length = strlen(buffer);
-    char *new_buffer = (char*)malloc(length + 2); // extra char, null-byte
-    assert(new_buffer);
-    memcpy(new_buffer, buffer, length);
-    new_buffer[length] = c;
-    new_buffer[length + 1] = 0;
-    free(buffer);
-    return new_buffer;
+    // char is signed, so the sorted output starts at -128
+    for (int c = CHAR_MIN; c <= CHAR_MAX; ++c) {
+        unsigned char bucket = (unsigned char) c;
+        write_run((char) c, histograms[0][bucket] + histograms[1][bucket] + histograms[2][bucket] + histograms[3][bucket]);
+    }
+    effi_flush();
 }
 
 void print_very_slowly(char c, size_t num_lines) {
-    char *buffer = malloc(1);
-    *buffer = 0;
+    // row i is i copies of c, written straight into the output buffer
     for (size_t i = 0; i < num_lines; ++i) {
-        for (size_t j = 0; j < i; ++j) {
-            buffer = append_character(buffer, c);
-        }
-        buffer = append_character(buffer, '\n');
+        write_run(c, i);
+        write_character('\n');
     }
+    effi_flush();
+}
+
+static const char digit_pairs[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
 
-    // Question for studies: why is this copy needed?
-    char *copy = buffer;
-    while(*copy)
-        effi_putchar(*copy++);
-    free(buffer);
+// smallest number with i + 1 digits, except index 0 so that zero still gets a digit
+static const unsigned long long digit_thresholds[20] = {
+    0ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL,
+};
+
+static size_t digit_count(unsigned long long value) {
+    // 1233 / 4096 approximates log10(2), the guess is exact or one too small
+    size_t guess = ((NUM_BITS_ULL - __builtin_clzll(value | 1)) * 1233) >> 12;
+    return guess + (value >= digit_thresholds[guess]);
 }
 
+// writes into the output buffer without flushing, so callers can append more
+static void write_number(long long number) {
+    char buffer[20]; // '-' and 19 digits of 9223372036854775808
+    size_t negative = number < 0;
+    // negating in unsigned arithmetic also covers -9223372036854775808
+    unsigned long long magnitude = negative ? 0ULL - (unsigned long long) number : (unsigned long long) number;
+    size_t length = negative + digit_count(magnitude);
+    buffer[0] = '-';
+
+    char *end = buffer + length;
+    while (magnitude >= 100) {
+        end -= 2;
+        memcpy(end, digit_pairs + 2 * (magnitude % 100), 2);
+        magnitude /= 100;
+    }
+    if (magnitude >= 10) {
+        end -= 2;
+        memcpy(end, digit_pairs + 2 * magnitude, 2);
+    } else {
+        *--end = (char) ('0' + magnitude);
+    }
+    effi_write(buffer, length);
+}
 
 /**
  * this method need not be altered as it should be correct
  */
 void print_number(long long number) {
-    if (((unsigned long long) number) == 0x8000000000000000ULL) { // assume two's complement
-        // -9223372036854775808
-        effi_putchar('-');
-        effi_putchar('9');
-        effi_putchar('2');
-        effi_putchar('2');
-        effi_putchar('3');
-        effi_putchar('3');
-        effi_putchar('7');
-        effi_putchar('2');
-        effi_putchar('0');
-        effi_putchar('3');
-        effi_putchar('6');
-        effi_putchar('8');
-        effi_putchar('5');
-        effi_putchar('4');
-        effi_putchar('7');
-        effi_putchar('7');
-        effi_putchar('5');
-        effi_putchar('8');
-        effi_putchar('0');
-        effi_putchar('8');
-        return;
-    }
-    if (number < 0) {
-        effi_putchar('-');
-        number = -number;
-    }
-
-    long long max_divisor = 1000000000000000000LL;
-    bool printing_number = false;
-    while (max_divisor != 0) {
-        long long result = number / max_divisor;
-        if (result != 0) {
-            printing_number = true;
-            effi_putchar('0' + result); // technically UB as ASCII is not defined
-        } else if (printing_number) {
-            effi_putchar('0');
-        }
-        number %= max_divisor;
-        max_divisor /= 10;
-    }
-    if (!printing_number) {
-        effi_putchar('0');
-    }
+    write_number(number);
+    effi_flush();
 }
@@ -0,0 +1,309 @@
+#define _GNU_SOURCE
+// headers from exercise
+#include "effi_sink.h"
+#include "effi_putchar.h"
+
+// headers from standard library
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+
+// default hook, weak so programs that only use sinks need not define it
+__attribute__((weak)) void effi_putchar(char c) {
+    putchar(c);
+}
+
+static void memory_write(void *context, const char *buffer, size_t length) {
+    struct effi_memory_buffer *memory = context;
+    // after a lost span the buffer would have a hole, so nothing is appended any more
+    if (memory->error)
+        return;
+    if (memory->capacity - memory->length < length) {
+        if (length > SIZE_MAX - memory->length) {
+            memory->error = ENOMEM;
+            return;
+        }
+        size_t capacity = memory->capacity ? memory->capacity : 64;
+        while (capacity - memory->length < length)
+            capacity = capacity > SIZE_MAX / 2 ? memory->length + length : capacity * 2;
+        if (memory->limit && capacity > memory->limit) {
+            if (memory->limit - memory->length < length) {
+                memory->error = ENOMEM;
+                return;
+            }
+            capacity = memory->limit;
+        }
+        char *data = realloc(memory->data, capacity);
+        if (!data) {
+            memory->error = ENOMEM;
+            return;
+        }
+        memory->data = data;
+        memory->capacity = capacity;
+    }
+    memcpy(memory->data + memory->length, buffer, length);
+    memory->length += length;
+}
+
+static int memory_status(void *context) {
+    const struct effi_memory_buffer *memory = context;
+    return memory->error;
+}
+
+struct effi_sink effi_memory_sink(struct effi_memory_buffer *buffer) {
+    return (struct effi_sink) {memory_write, buffer, NULL, memory_status};
+}
+
+void effi_memory_buffer_release(struct effi_memory_buffer *buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+    buffer->error = 0;
+}
+
+static void fd_write(void *context, const char *buffer, size_t length) {
+    const struct effi_fd *fd = context;
+    while (length) {
+        ssize_t written = write(fd->fd, buffer, length);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        buffer += written;
+        length -= (size_t) written;
+    }
+}
+
+struct effi_sink effi_fd_sink(struct effi_fd *fd) {
+    return (struct effi_sink) {fd_write, fd, NULL, NULL};
+}
+
+static void counting_write(void *context, const char *buffer, size_t length) {
+    (void) buffer;
+    struct effi_counter *counter = context;
+    counter->bytes += length;
+    ++counter->writes;
+}
+
+struct effi_sink effi_counting_sink(struct effi_counter *counter) {
+    return (struct effi_sink) {counting_write, counter, NULL, NULL};
+}
+
+static void writev_flush(void *context) {
+    struct effi_writev *writev_state = context;
+    struct iovec *spans = writev_state->spans;
+    size_t num_spans = writev_state->num_spans;
+    while (num_spans) {
+        ssize_t written = writev(writev_state->fd, spans, (int) num_spans);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        // skip what the kernel took, a short write can end inside a span
+        while (num_spans && (size_t) written >= spans->iov_len) {
+            written -= (ssize_t) spans->iov_len;
+            ++spans;
+            --num_spans;
+        }
+        if (num_spans) {
+            spans->iov_base = (char *) spans->iov_base + written;
+            spans->iov_len -= (size_t) written;
+        }
+    }
+    writev_state->num_spans = 0;
+}
+
+static void writev_write(void *context, const char *buffer, size_t length) {
+    struct effi_writev *writev_state = context;
+    if (writev_state->num_spans == EFFI_WRITEV_MAX_SPANS)
+        writev_flush(writev_state);
+    writev_state->spans[writev_state->num_spans++] = (struct iovec) {(void *) buffer, length};
+}
+
+struct effi_sink effi_writev_sink(struct effi_writev *writev_state) {
+    return (struct effi_sink) {writev_write, writev_state, writev_flush, NULL};
+}
+
+// blocking write of everything from offset on, -1 writes at the current position
+static void write_all(int fd, const char *buffer, size_t length, long long offset) {
+    while (length) {
+        ssize_t written = offset < 0 ? write(fd, buffer, length) : pwrite(fd, buffer, length, (off_t) offset);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        buffer += written;
+        length -= (size_t) written;
+        if (offset >= 0)
+            offset += written;
+    }
+}
+
+// collects finished writes and frees their slots, waits until at least min_complete are done
+static void uring_reap(struct effi_uring *uring, unsigned min_complete) {
+    if (min_complete)
+        syscall(__NR_io_uring_enter, uring->ring_fd, 0, min_complete, IORING_ENTER_GETEVENTS, NULL, 0);
+    unsigned head = *uring->cq_head;
+    unsigned tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+        const struct io_uring_cqe *cqe = (const struct io_uring_cqe *) uring->cqes + (head & *uring->cq_mask);
+        size_t slot = (size_t) cqe->user_data;
+        size_t written = cqe->res > 0 ? (size_t) cqe->res : 0;
+        // short writes and errors are finished synchronously
+        if (written < uring->slot_fill[slot]) {
+            long long offset = uring->slot_offset[slot] < 0 ? -1 : uring->slot_offset[slot] + (long long) written;
+            write_all(uring->fd, uring->slots + slot * EFFI_URING_SLOT_SIZE + written, uring->slot_fill[slot] - written, offset);
+        }
+        uring->slot_fill[slot] = 0;
+        uring->slot_busy[slot] = 0;
+        --uring->in_flight;
+    }
+    __atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+}
+
+static void uring_submit_current(struct effi_uring *uring) {
+    size_t slot = uring->current_slot;
+    // unseekable files have no offsets to order the writes by
+    while (uring->offset < 0 && uring->in_flight)
+        uring_reap(uring, 1);
+
+    unsigned tail = *uring->sq_tail;
+    unsigned index = tail & *uring->sq_mask;
+    struct io_uring_sqe *sqe = (struct io_uring_sqe *) uring->sqes + index;
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = uring->fd;
+    sqe->addr = (unsigned long long) (uintptr_t) (uring->slots + slot * EFFI_URING_SLOT_SIZE);
+    sqe->len = (unsigned) uring->slot_fill[slot];
+    sqe->off = uring->offset < 0 ? (unsigned long long) -1 : (unsigned long long) uring->offset;
+    sqe->user_data = slot;
+    uring->sq_array[index] = index;
+    __atomic_store_n(uring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    syscall(__NR_io_uring_enter, uring->ring_fd, 1, 0, 0, NULL, 0);
+
+    uring->slot_offset[slot] = uring->offset;
+    if (uring->offset >= 0)
+        uring->offset += (long long) uring->slot_fill[slot];
+    uring->slot_busy[slot] = 1;
+    ++uring->in_flight;
+    uring->current_slot = (slot + 1) % EFFI_URING_SLOTS;
+}
+
+static void uring_write(void *context, const char *buffer, size_t length) {
+    struct effi_uring *uring = context;
+    if (uring->ring_fd < 0) {
+        writev_write(&uring->fallback, buffer, length);
+        return;
+    }
+    while (length) {
+        size_t slot = uring->current_slot;
+        while (uring->slot_busy[slot])
+            uring_reap(uring, 1);
+        size_t span = EFFI_URING_SLOT_SIZE - uring->slot_fill[slot];
+        if (span > length)
+            span = length;
+        memcpy(uring->slots + slot * EFFI_URING_SLOT_SIZE + uring->slot_fill[slot], buffer, span);
+        uring->slot_fill[slot] += span;
+        buffer += span;
+        length -= span;
+        if (uring->slot_fill[slot] == EFFI_URING_SLOT_SIZE)
+            uring_submit_current(uring);
+    }
+}
+
+static void uring_flush(void *context) {
+    struct effi_uring *uring = context;
+    if (uring->ring_fd < 0) {
+        writev_flush(&uring->fallback);
+        return;
+    }
+    // queue the partial slot without waiting, the fill of a busy slot belongs to its write in flight
+    if (!uring->slot_busy[uring->current_slot] && uring->slot_fill[uring->current_slot])
+        uring_submit_current(uring);
+    uring_reap(uring, 0);
+}
+
+int effi_uring_open(struct effi_uring *uring, int fd) {
+    memset(uring, 0, sizeof(*uring));
+    uring->fd = fd;
+    uring->ring_fd = -1;
+    uring->fallback.fd = fd;
+    uring->offset = lseek(fd, 0, SEEK_CUR);
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int ring_fd = (int) syscall(__NR_io_uring_setup, EFFI_URING_SLOTS, &params);
+    if (ring_fd < 0)
+        return -1;
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    // older kernels map both rings separately, that case just uses writev
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+        close(ring_fd);
+        return -1;
+    }
+    uring->ring_size = sq_size > cq_size ? sq_size : cq_size;
+    uring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    char *ring = mmap(NULL, uring->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    void *sqes = mmap(NULL, uring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    char *slots = mmap(NULL, EFFI_URING_SLOTS * EFFI_URING_SLOT_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED || sqes == MAP_FAILED || slots == MAP_FAILED) {
+        if (ring != MAP_FAILED)
+            munmap(ring, uring->ring_size);
+        if (sqes != MAP_FAILED)
+            munmap(sqes, uring->sqes_size);
+        if (slots != MAP_FAILED)
+            munmap(slots, EFFI_URING_SLOTS * EFFI_URING_SLOT_SIZE);
+        close(ring_fd);
+        return -1;
+    }
+
+    uring->ring_fd = ring_fd;
+    uring->ring = ring;
+    uring->sqes = sqes;
+    uring->slots = slots;
+    uring->sq_tail = (unsigned *) (ring + params.sq_off.tail);
+    uring->sq_mask = (unsigned *) (ring + params.sq_off.ring_mask);
+    uring->sq_array = (unsigned *) (ring + params.sq_off.array);
+    uring->cq_head = (unsigned *) (ring + params.cq_off.head);
+    uring->cq_tail = (unsigned *) (ring + params.cq_off.tail);
+    uring->cq_mask = (unsigned *) (ring + params.cq_off.ring_mask);
+    uring->cqes = ring + params.cq_off.cqes;
+    return 0;
+}
+
+void effi_uring_close(struct effi_uring *uring) {
+    if (uring->ring_fd < 0) {
+        writev_flush(&uring->fallback);
+        return;
+    }
+    if (!uring->slot_busy[uring->current_slot] && uring->slot_fill[uring->current_slot])
+        uring_submit_current(uring);
+    while (uring->in_flight)
+        uring_reap(uring, 1);
+    // writes with explicit offsets leave the file position alone
+    if (uring->offset >= 0)
+        lseek(uring->fd, (off_t) uring->offset, SEEK_SET);
+    munmap(uring->ring, uring->ring_size);
+    munmap(uring->sqes, uring->sqes_size);
+    munmap(uring->slots, EFFI_URING_SLOTS * EFFI_URING_SLOT_SIZE);
+    close(uring->ring_fd);
+    uring->ring_fd = -1;
+}
+
+struct effi_sink effi_uring_sink(struct effi_uring *uring) {
+    return (struct effi_sink) {uring_write, uring, uring_flush, NULL};
+}
@@ -0,0 +1,90 @@
+extern "C" {
+#include "print.h"
+}
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <algorithm>
+using namespace std::literals;
+
+
+static std::string expected{};
+static std::string actual {};
+static long long call_counter = 0;
+extern "C" {
+void effi_putchar(char c) {
+    ASSERT_LT(call_counter, expected.size());
+    EXPECT_EQ(expected.at(call_counter++), c);
+    actual.push_back(c);
+}
+}
+
+
+auto result_for_string(std::string input) {
+    std::sort(input.begin(), input.end());
+    return input;
+}
+
+/*
+static void short_leaky_bench(benchmark::State &state) {
+    auto init = "zyxwvutsrqponmlkjihgfedcba"s;
+    while (init.size() < (1 << 10)) init += init;
+    init.resize(1 << 10);
+    for (auto _ : state) print_leaky(init.c_str());
+}
+BENCHMARK(short_leaky_bench);
+*/
+TEST(LeakyBench, ShortBench) {
+    auto init = "zyxwvutsrqponmlkjihgfedcba"s;
+    while (init.size() < (1 << 10)) init += init;
+    init.resize(1 << 10);
+    expected = result_for_string(init);
+    call_counter = 0;
+    actual = "";
+
+    print_leaky(init.c_str());
+
+    EXPECT_EQ(expected, actual);
+    EXPECT_EQ(call_counter, expected.size());
+}
+
+/*
+static void medium_leaky_bench(benchmark::State &state) {
+    auto init = "zyxwvutsrqponmlkjihgfedcba"s;
+    while (init.size() < (1 << 20)) init += init;
+    init.resize(1 << 20);
+    for (auto _ : state) print_leaky(init.c_str());
+}
+BENCHMARK(medium_leaky_bench);
+*/
+TEST(LeakyBench, MediumBench) {
+    auto init = "zyxwvutsrqponmlkjihgfedcba"s;
+    while (init.size() < (1 << 20)) init += init;
+    init.resize(1 << 20);
+    expected = result_for_string(init);
+    call_counter = 0;
+    actual = "";
+
+    print_leaky(init.c_str());
+
+    EXPECT_EQ(expected, actual);
+    EXPECT_EQ(call_counter, expected.size());
+}
+
+// long_leaky_bench runs on 64 MiB, which is benchmark work; a few hundred KiB of every
+// byte value but the terminator fill all histogram buckets just as well
+TEST(LeakyBench, LongBench) {
+    std::string init;
+    for (int c = 1; c < 256; c++) init.push_back(static_cast<char>(c));
+    while (init.size() < (1 << 18)) init += init;
+    init.resize(1 << 18);
+    expected = result_for_string(init);
+    call_counter = 0;
+    actual = "";
+
+    print_leaky(init.c_str());
+
+    EXPECT_EQ(expected, actual);
+    EXPECT_EQ(call_counter, expected.size());
+}
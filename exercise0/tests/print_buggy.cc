@@ -90,3 +90,38 @@ TEST(PrintBuggy, TestAlotofCharacters) {
     EXPECT_EQ(call_counter, expected.size());
 }
 
+
+TEST(PrintBuggy, TestAllAlignmentsAndLengths) {
+    // negative chars and lengths around the vector widths, starting at every offset in a block
+    std::string storage(256, '\0');
+    for (size_t i = 0; i < storage.size(); ++i)
+        storage[i] = static_cast<char>(1 + (i * 37) % 255);
+    for (size_t offset = 0; offset < 32; ++offset) {
+        for (size_t length : {1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 200}) {
+            auto terminated = storage;
+            terminated[offset + length] = '\0';
+            expected = result_for_string(storage.substr(offset, length));
+            call_counter = 0;
+            actual = "";
+
+            print_buggy(terminated.data() + offset);
+
+            EXPECT_EQ(expected, actual);
+            EXPECT_EQ(call_counter, expected.size());
+        }
+    }
+}
+
+TEST(PrintBuggy, TestManyStrings) {
+    const char *inputs[] = {"aaaaaaaa", "", "abcedfghijklm", "!\"§$%&/()=?"};
+    expected = "";
+    for (auto input : inputs)
+        expected += input[0] ? result_for_string(input) : ": 0/0=0\n"s;
+    call_counter = 0;
+    actual = "";
+
+    print_buggy_many(inputs, std::size(inputs));
+
+    EXPECT_EQ(expected, actual);
+    EXPECT_EQ(call_counter, expected.size());
+}
@@ -0,0 +1,57 @@
+extern "C" {
+#include "print.h"
+}
+
+#include <climits>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+using namespace std::literals;
+
+
+static std::string expected{};
+static std::string actual {};
+static long long call_counter = 0;
+extern "C" {
+void effi_putchar(char c) {
+    ASSERT_LT(call_counter, expected.size());
+    EXPECT_EQ(expected.at(call_counter++), c);
+    actual.push_back(c);
+}
+}
+
+
+static void check_number(long long number) {
+    expected = std::to_string(number);
+    call_counter = 0;
+    actual = "";
+
+    print_number(number);
+
+    EXPECT_EQ(expected, actual);
+    EXPECT_EQ(call_counter, expected.size());
+}
+
+TEST(PrintNumber, TestZero) {
+    check_number(0);
+}
+
+TEST(PrintNumber, TestSmallNumbers) {
+    for (long long number = -1000; number <= 1000; ++number)
+        check_number(number);
+}
+
+TEST(PrintNumber, TestPowersOfTen) {
+    for (long long power = 1; power <= 1000000000000000000LL; power *= 10) {
+        check_number(power - 1);
+        check_number(power);
+        check_number(power + 1);
+        check_number(-power);
+    }
+}
+
+TEST(PrintNumber, TestExtremes) {
+    check_number(LLONG_MAX);
+    check_number(LLONG_MIN);
+    check_number(LLONG_MIN + 1);
+}
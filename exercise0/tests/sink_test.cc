@@ -0,0 +1,223 @@
+extern "C" {
+#include "print.h"
+#include "effi_sink.h"
+}
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+using namespace std::literals;
+
+// no effi_putchar here, all output goes through the sinks under test
+
+
+TEST(Sink, MemorySinkCollectsOutput) {
+    effi_memory_buffer buffer {};
+    auto sink = effi_memory_sink(&buffer);
+    effi_set_sink(&sink);
+
+    print_helloworld();
+    print_number(-42);
+    print_very_slowly('x', 3);
+
+    effi_set_sink(nullptr);
+    EXPECT_EQ("Hello World!\n-42\nx\nxx\n"s, std::string(buffer.data, buffer.length));
+    effi_memory_buffer_release(&buffer);
+    EXPECT_EQ(buffer.data, nullptr);
+    EXPECT_EQ(buffer.length, 0u);
+}
+
+TEST(Sink, MemorySinkTakesLargeSpans) {
+    auto input = std::string(3 * EFFI_OUTPUT_BUFFER_SIZE, 'a');
+    effi_memory_buffer buffer {};
+    auto sink = effi_memory_sink(&buffer);
+    effi_set_sink(&sink);
+
+    print_leaky(input.c_str());
+
+    effi_set_sink(nullptr);
+    EXPECT_EQ(input, std::string(buffer.data, buffer.length));
+    effi_memory_buffer_release(&buffer);
+}
+
+TEST(Sink, MemorySinkReportsFailedGrowth) {
+    // the limit makes growth fail the same way a failed realloc does
+    effi_memory_buffer buffer {};
+    buffer.limit = 32;
+    auto sink = effi_memory_sink(&buffer);
+    effi_set_sink(&sink);
+
+    print_helloworld();
+    EXPECT_EQ(effi_flush(), 0);
+    const std::string span(100, 'x');
+    effi_write(span.data(), span.size());
+    EXPECT_EQ(effi_flush(), ENOMEM);
+    // the error sticks and later output is dropped instead of leaving a gap
+    print_helloworld();
+    EXPECT_EQ(effi_flush(), ENOMEM);
+
+    effi_set_sink(nullptr);
+    EXPECT_EQ("Hello World!\n"s, std::string(buffer.data, buffer.length));
+    effi_memory_buffer_release(&buffer);
+    EXPECT_EQ(buffer.error, 0);
+
+    // output up to the limit still fits after the release
+    effi_set_sink(&sink);
+    effi_write(span.data(), 32);
+    EXPECT_EQ(effi_flush(), 0);
+    effi_set_sink(nullptr);
+    EXPECT_EQ(std::string(buffer.data, buffer.length), span.substr(0, 32));
+    effi_memory_buffer_release(&buffer);
+}
+
+TEST(Sink, BuggyManyStreamsFullOutputBuffers) {
+    // more output than the ring buffer holds
+    std::vector<std::string> lines(4000);
+    std::vector<const char *> strings;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        lines[i] = std::to_string(i) + std::string(40 + i % 30, 'a' + i % 26);
+        strings.push_back(lines[i].c_str());
+    }
+
+    effi_memory_buffer single {};
+    auto single_sink = effi_memory_sink(&single);
+    effi_set_sink(&single_sink);
+    for (auto string : strings)
+        print_buggy(string);
+    effi_set_sink(nullptr);
+    const std::string expected(single.data, single.length);
+    effi_memory_buffer_release(&single);
+    ASSERT_GT(expected.size(), size_t {EFFI_OUTPUT_BUFFER_SIZE});
+
+    effi_memory_buffer batched {};
+    auto batched_sink = effi_memory_sink(&batched);
+    effi_set_sink(&batched_sink);
+    print_buggy_many(strings.data(), strings.size());
+    effi_set_sink(nullptr);
+    EXPECT_EQ(std::string(batched.data, batched.length), expected);
+    effi_memory_buffer_release(&batched);
+
+    effi_counter counter {};
+    auto counting_sink = effi_counting_sink(&counter);
+    effi_set_sink(&counting_sink);
+    print_buggy_many(strings.data(), strings.size());
+    effi_set_sink(nullptr);
+    // a full output buffer drains in at most two spans as it may wrap, plus the final flush
+    EXPECT_LE(counter.writes, 2 * (expected.size() / EFFI_OUTPUT_BUFFER_SIZE + 1));
+    EXPECT_EQ(counter.bytes, expected.size());
+}
+
+TEST(Sink, CountingSinkBatchesWrites) {
+    effi_counter counter {};
+    auto sink = effi_counting_sink(&counter);
+    effi_set_sink(&sink);
+
+    print_very_slowly('D', 1000);
+
+    effi_set_sink(nullptr);
+    EXPECT_EQ(counter.bytes, 1000u * 999u / 2u + 1000u);
+    // one write per full ring buffer plus the final flush
+    EXPECT_LE(counter.writes, counter.bytes / EFFI_OUTPUT_BUFFER_SIZE + 2);
+}
+
+TEST(Sink, FdSinkWritesToFile) {
+    char path[] = "sink_test_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    effi_fd file {fd};
+    auto sink = effi_fd_sink(&file);
+    effi_set_sink(&sink);
+
+    print_buggy("abc");
+
+    effi_set_sink(nullptr);
+    std::string contents(64, '\0');
+    ssize_t length = pread(fd, contents.data(), contents.size(), 0);
+    ASSERT_GE(length, 0);
+    contents.resize(length);
+    EXPECT_EQ("abc: 294/3=b\n"s, contents);
+    close(fd);
+    unlink(path);
+}
+
+static std::string read_file(int fd) {
+    std::string contents;
+    char block[4096];
+    ssize_t length;
+    for (off_t offset = 0; (length = pread(fd, block, sizeof(block), offset)) > 0; offset += length)
+        contents.append(block, length);
+    return contents;
+}
+
+static std::string triangle(char c, size_t num_lines) {
+    auto result = ""s;
+    for (size_t i = 0; i < num_lines; ++i)
+        result += std::string(i, c) + '\n';
+    return result;
+}
+
+TEST(Sink, WritevSinkWritesToFile) {
+    char path[] = "sink_test_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    effi_writev file {};
+    file.fd = fd;
+    auto sink = effi_writev_sink(&file);
+    effi_set_sink(&sink);
+
+    print_helloworld();
+    print_very_slowly('W', 1000);
+
+    effi_set_sink(nullptr);
+    EXPECT_EQ("Hello World!\n"s + triangle('W', 1000), read_file(fd));
+    close(fd);
+    unlink(path);
+}
+
+TEST(Sink, UringSinkWritesToFile) {
+    char path[] = "sink_test_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, "head\n", 5), 5);
+    effi_uring uring;
+    effi_uring_open(&uring, fd); // the writev fallback has to produce the same file
+    auto sink = effi_uring_sink(&uring);
+    effi_set_sink(&sink);
+
+    print_very_slowly('U', 2000);
+    print_helloworld();
+
+    effi_set_sink(nullptr);
+    effi_uring_close(&uring);
+    EXPECT_EQ(lseek(fd, 0, SEEK_CUR), static_cast<off_t>(5 + triangle('U', 2000).size() + 13));
+    EXPECT_EQ("head\n"s + triangle('U', 2000) + "Hello World!\n", read_file(fd));
+    close(fd);
+    unlink(path);
+}
+
+TEST(Sink, UringSinkKeepsPipeOrder) {
+    int pipe_fds[2];
+    ASSERT_EQ(pipe(pipe_fds), 0);
+    // large enough for the whole output, so nothing has to read concurrently
+    fcntl(pipe_fds[1], F_SETPIPE_SZ, 1 << 20);
+    effi_uring uring;
+    effi_uring_open(&uring, pipe_fds[1]);
+    auto sink = effi_uring_sink(&uring);
+    effi_set_sink(&sink);
+
+    print_very_slowly('P', 500);
+
+    effi_set_sink(nullptr);
+    effi_uring_close(&uring);
+    close(pipe_fds[1]);
+    std::string contents;
+    char block[4096];
+    for (ssize_t length; (length = read(pipe_fds[0], block, sizeof(block))) > 0;)
+        contents.append(block, length);
+    close(pipe_fds[0]);
+    EXPECT_EQ(triangle('P', 500), contents);
+}
@@ -83,6 +83,56 @@ static void BM_LinkedListAlloc(benchmark::State &state) {
 }
 BENCHMARK(BM_LinkedListAlloc);
 
+// Same list as BM_LinkedListAlloc, only the cold teardown is measured
+template<bool sized>
+static void linked_list_teardown(benchmark::State &state) {
+    constexpr auto limit = 4 * 1024  * 1024;
+    balloc_setup();
+    for (auto _ : state) {
+        state.PauseTiming();
+        singly_linked_list first {nullptr};
+        singly_linked_list *curr {&first};
+        for (long sum = 0; sum < limit; sum += sizeof(singly_linked_list)) {
+            curr->next = reinterpret_cast<singly_linked_list *>(alloc(sizeof(singly_linked_list)));
+            curr       = curr->next;
+            curr->next = nullptr;
+        }
+        state.ResumeTiming();
+        for (singly_linked_list *curr {first.next}; curr;) {
+            auto copy = curr;
+            curr = curr->next;
+            if constexpr (sized)
+                dealloc_sized(copy, sizeof(singly_linked_list));
+            else
+                dealloc(copy);
+        }
+    }
+    balloc_teardown();
+}
+
+static void BM_LinkedListTeardown(benchmark::State &state) {
+    linked_list_teardown<false>(state);
+}
+BENCHMARK(BM_LinkedListTeardown);
+
+static void BM_LinkedListTeardownSized(benchmark::State &state) {
+    linked_list_teardown<true>(state);
+}
+BENCHMARK(BM_LinkedListTeardownSized);
+
+// Free path of large blocks, where dealloc() has to read the size header
+static void BM_LargeDeallocSized(benchmark::State &state) {
+    const size_t size = state.range(0);
+    balloc_setup();
+    for (auto _ : state) {
+        void *ptr = alloc(size);
+        benchmark::DoNotOptimize(ptr);
+        dealloc_sized(ptr, size);
+    }
+    balloc_teardown();
+}
+BENCHMARK(BM_LargeDeallocSized)->Range(128, 1 << 16);
+
 
 // ===== ALLOCATION PATTERN BENCHMARKS =====
 
@@ -162,6 +212,44 @@ static void BM_AllocationReuse(benchmark::State &state) {
 }
 BENCHMARK(BM_AllocationReuse)->Range(1, 1 << 10);
 
+// One allocation behind thousands of stale free-stack entries of full slabs
+static void BM_SkipFullSlabs(benchmark::State &state) {
+    const size_t num_slabs = state.range(0);
+    const size_t chunks_per_slab = 64;
+    std::vector<void*> blocks((num_slabs + 1) * chunks_per_slab);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        balloc_setup();
+        // Each consecutive group of chunks_per_slab blocks fills one slab
+        for (auto &block : blocks) {
+            block = alloc(64);
+        }
+        // One extra slab with a free chunk ends up below the stale entries
+        dealloc(blocks[num_slabs * chunks_per_slab]);
+        // Two frees per slab push every slab twice, refilling drops only the upper copies
+        for (size_t i = 0; i < num_slabs; i++) {
+            dealloc(blocks[i * chunks_per_slab]);
+        }
+        for (size_t i = 0; i < num_slabs; i++) {
+            dealloc(blocks[i * chunks_per_slab + 1]);
+        }
+        for (size_t i = 0; i < 2 * num_slabs; i++) {
+            benchmark::DoNotOptimize(alloc(64));
+        }
+        state.ResumeTiming();
+
+        void* ptr = alloc(64);
+        benchmark::DoNotOptimize(ptr);
+
+        state.PauseTiming();
+        balloc_teardown();
+        state.ResumeTiming();
+    }
+}
+// Setup dwarfs the measured alloc, so the iteration count is fixed
+BENCHMARK(BM_SkipFullSlabs)->RangeMultiplier(4)->Range(1 << 10, 1 << 14)->Iterations(256);
+
 // ===== SIZE CLASS BENCHMARKS =====
 
 // Benchmark allocation by power-of-2 sizes
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <string>
+#include <unistd.h>
+
+extern "C" {
+#include "balloc.h"
+}
+
+// a pointer-rich cache: a binary tree of small nodes
+struct cache_node {
+    cache_node *left;
+    cache_node *right;
+    size_t key;
+    size_t value;
+};
+
+static cache_node *build_cache(size_t first, size_t last) {
+    if (first >= last) return nullptr;
+    size_t middle = first + (last - first) / 2;
+    auto node     = reinterpret_cast<cache_node *>(alloc(sizeof(cache_node)));
+    node->key     = middle;
+    node->value   = middle * middle;
+    node->left    = build_cache(first, middle);
+    node->right   = build_cache(middle + 1, last);
+    return node;
+}
+
+static size_t lookup(const cache_node *node, size_t key) {
+    while (node && node->key != key) node = key < node->key ? node->left : node->right;
+    return node ? node->value : 0;
+}
+
+static std::string heap_path() {
+    return "balloc_persistent_bench_" + std::to_string(getpid()) + ".heap";
+}
+
+// cold start: rebuild the whole cache after setup
+static void BM_RebuildCache(benchmark::State &state) {
+    const size_t num_nodes = state.range(0);
+    for (auto _ : state) {
+        balloc_setup();
+        auto root = build_cache(0, num_nodes);
+        benchmark::DoNotOptimize(lookup(root, num_nodes / 3));
+        state.PauseTiming();
+        balloc_teardown();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_RebuildCache)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+// warm restart: reopen the heap file the cache was built in
+static void BM_WarmRestart(benchmark::State &state) {
+    const size_t num_nodes = state.range(0);
+    auto path              = heap_path();
+    unlink(path.c_str());
+    if (balloc_setup_persistent(path.c_str())) {
+        state.SkipWithError("could not create the heap file");
+        return;
+    }
+    balloc_set_root(build_cache(0, num_nodes));
+    balloc_teardown();
+
+    for (auto _ : state) {
+        if (balloc_setup_persistent(path.c_str())) {
+            state.SkipWithError("could not reopen the heap file");
+            break;
+        }
+        auto root = reinterpret_cast<cache_node *>(balloc_get_root());
+        benchmark::DoNotOptimize(lookup(root, num_nodes / 3));
+        state.PauseTiming();
+        balloc_teardown();
+        state.ResumeTiming();
+    }
+    unlink(path.c_str());
+}
+BENCHMARK(BM_WarmRestart)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+BENCHMARK_MAIN();
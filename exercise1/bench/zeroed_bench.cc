@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "balloc.h"
+}
+
+// zeroed allocation through the allocator, memset is skipped for untouched memory
+static void BM_AllocZeroed(benchmark::State &state) {
+    const size_t size = state.range(0);
+    balloc_setup();
+    for (auto _ : state) {
+        void *ptr = alloc_zeroed(size);
+        benchmark::DoNotOptimize(ptr);
+        dealloc(ptr);
+    }
+    balloc_teardown();
+    state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_AllocZeroed)->RangeMultiplier(4)->Range(64, 1 << 20);
+
+// the same zeroed allocation done by hand
+static void BM_AllocMemset(benchmark::State &state) {
+    const size_t size = state.range(0);
+    balloc_setup();
+    for (auto _ : state) {
+        void *ptr = alloc(size);
+        memset(ptr, 0, size);
+        benchmark::DoNotOptimize(ptr);
+        dealloc(ptr);
+    }
+    balloc_teardown();
+    state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_AllocMemset)->RangeMultiplier(4)->Range(64, 1 << 20);
+
+// many live zeroed blocks, so most of them come from untouched slab chunks
+static void BM_BatchAllocZeroed(benchmark::State &state) {
+    const size_t size = state.range(0);
+    constexpr int batch_size = 1 << 10;
+    std::vector<void *> allocations(batch_size);
+    for (auto _ : state) {
+        state.PauseTiming();
+        balloc_setup();
+        state.ResumeTiming();
+        for (int i = 0; i < batch_size; i++) {
+            allocations[i] = alloc_zeroed(size);
+            benchmark::DoNotOptimize(allocations[i]);
+        }
+        state.PauseTiming();
+        balloc_teardown();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_BatchAllocZeroed)->Arg(8)->Arg(32)->Arg(56);
+
+static void BM_BatchAllocMemset(benchmark::State &state) {
+    const size_t size = state.range(0);
+    constexpr int batch_size = 1 << 10;
+    std::vector<void *> allocations(batch_size);
+    for (auto _ : state) {
+        state.PauseTiming();
+        balloc_setup();
+        state.ResumeTiming();
+        for (int i = 0; i < batch_size; i++) {
+            allocations[i] = alloc(size);
+            memset(allocations[i], 0, size);
+            benchmark::DoNotOptimize(allocations[i]);
+        }
+        state.PauseTiming();
+        balloc_teardown();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_BatchAllocMemset)->Arg(8)->Arg(32)->Arg(56);
+
+BENCHMARK_MAIN();
@@ -19,6 +19,12 @@
 //! minimum size of memory to allocate from the os
 #define BITMAP_PAGE_SIZE 4096
 
+//! fixed address the heap file of the persistent mode is mapped to,
+//! so pointers stored inside the heap stay valid across processes
+#define BALLOC_PERSISTENT_BASE ((void *) 0x200000000000ull)
+//! size of the heap file, the file is sparse so only used pages take up space
+#define BALLOC_PERSISTENT_SIZE (1ull << 32)
+
 //! minimum alingment for all adresses returned by the allocator
 #define BALLOC_ALIGNMENT 8
 #define BALLOC_ALIGNMENT_BITS 3
@@ -36,6 +42,10 @@ struct bitmap_alloc {
     //! bitmask indicating which chunks are occupied (1) or free (0)
     size_t occupied_areas;
 
+    //! bitmask indicating which chunks were handed out (1) since the memory was mapped
+    //! chunks with a 0 bit still hold the zero pages the os gave us
+    size_t touched_areas;
+
     //! pointer to the memory area managed by this allocator
     //! the total size is chunk_size * number of bits in size_t
     void *memory;
@@ -47,12 +57,41 @@ extern struct bitmap_alloc *bitmap_allocators;
 //! Number of bitmap allocators in the global array
 extern size_t num_bitmap_allocators;
 
+//! occupied_areas of the bitmap allocators in the global array, densely packed for scanning, one word per allocator
+extern size_t *occupied_words;
+
 // Setup/Teardown functions
 // Called before the first allocation
 void balloc_setup(void);
 // Called after the last allocation
 void balloc_teardown(void);
 
+/*!
+ * \brief setup variant that keeps all allocator state and memory in a file
+ * 
+ * The file is mapped at BALLOC_PERSISTENT_BASE. If it already holds a heap from an
+ * earlier balloc_teardown(), all objects allocated back then are available again,
+ * otherwise a new heap is created. Use instead of balloc_setup(), balloc_teardown()
+ * stores the state and unmaps the file.
+ * \param path the heap file, created if it does not exist
+ * \return 0 on success, -1 if the file could not be created, mapped or is no valid heap
+ * \attention a heap is only valid after balloc_teardown(), a crashed process leaves it unusable
+ */
+int balloc_setup_persistent(const char *path);
+
+/*!
+ * \brief remember an entry point to the objects in a persistent heap
+ * \param root pointer returned by balloc_get_root() after the heap is reopened
+ * \attention only has an effect between balloc_setup_persistent() and balloc_teardown()
+ */
+void balloc_set_root(void *root);
+
+/*!
+ * \brief get the pointer passed to balloc_set_root()
+ * \return the root of the persistent heap, NULL if there is none or no persistent heap is set up
+ */
+void *balloc_get_root(void);
+
 /*!
  * \brief allocate a chunk from a specific bitmap allocator
  * 
@@ -99,6 +138,17 @@ void dealloc_to_os(void *memory, size_t size);
  */
 void *alloc(size_t size);
 
+/*!
+ * \brief user-facing API to allocate zero-initialized memory
+ * 
+ * Behaves like alloc(), but the returned memory is filled with zeros (like calloc()).
+ * Chunks that were never handed out since they were mapped and fresh os allocations
+ * are already zero, so they are returned without a memset.
+ * \param size number of bytes to be (at least) allocated
+ * \return pointer to the zeroed memory, or NULL if allocation failed
+ */
+void *alloc_zeroed(size_t size);
+
 /*!
  * \brief user-facing API to free previously allocated memory
  * 
@@ -107,4 +157,15 @@ void *alloc(size_t size);
  */
 void dealloc(void *memory);
 
+/*!
+ * \brief user-facing API to free memory of a known size
+ * 
+ * Behaves like dealloc(), but the size class and the bitmap allocator are derived from
+ * the size and the address only, the freed memory itself is not read.
+ * \param memory pointer to the memory to be freed
+ * \param size the size that was passed to alloc() or alloc_zeroed() for this pointer
+ * \attention similarly to free(), you need to gracefully handle NULL
+ */
+void dealloc_sized(void *memory, size_t size);
+
 #endif /* DEFINED_P1_BITMAP_ALLOC_H */
@@ -7,9 +7,13 @@
  */
 
 #include <stddef.h>
+#include <stdint.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <string.h>
+#include <immintrin.h>
 
 #define AGGRESIVE_OPTIMIZATIONS
 
@@ -31,8 +35,15 @@
 
 #define DYNAMIC_ARRAY_INITIAL_NUMBER_PAGES 16
 
+//! distance between two slabs in the slab region, fits the slab of the largest chunk size
+#define SLAB_STRIDE MEMORY_SIZE_CHUNK(1ull << BITMAP_CHUNK_MAX_SIZE)
+//! address space reserved for slabs, pages are only backed once they are touched
+#define SLAB_REGION_SIZE (1ull << 35)
+//! slabs of a persistent heap live in the upper half of the heap file
+#define PERSISTENT_SLAB_REGION_OFFSET (BALLOC_PERSISTENT_SIZE / 2)
 
-#define BALLOC_METADATA_OS_ALLOCATION 0x8000000000000000ull
+//! "BALLOC01" in ascii, marks an initialized heap file
+#define BALLOC_PERSISTENT_MAGIC 0x3130434f4c4c4142ull
 
 typedef size_t balloc_metadata;
 
@@ -54,116 +65,377 @@ size_t max_num_bitmap_allocators;
 
 size_t bitmap_allocators_num_pages_allocated;
 
+/*!
+ * occupied_areas of every bitmap allocator, densely packed so full allocators can be
+ * skipped several at a time. This array is authoritative, the occupied_areas field in
+ * bitmap_allocators mirrors it for inspection.
+ */
+size_t *occupied_words = NULL;
+
 _stack free_bitmaps [BITMAP_CHUNK_MAX_SIZE - BITMAP_CHUNK_MIN_SIZE + 1];
 
-void init_bitmap_allocators() {
-    bitmap_allocators = alloc_from_os(BITMAP_PAGE_SIZE * DYNAMIC_ARRAY_INITIAL_NUMBER_PAGES);
+/*!
+ * Slab i lives at slab_region + i * SLAB_STRIDE, so the bitmap allocator of a chunk
+ * follows from its address alone. Slab chunks carry no header; only os allocations
+ * have a balloc_metadata word with their size in front of the user memory.
+ */
+char *slab_region = NULL;
+
+size_t slab_region_size = 0;
+
+/*!
+ * \brief first page of a persistent heap file
+ *
+ * Holds the allocator state that otherwise lives in globals, so a later
+ * balloc_setup_persistent() can pick up where the last teardown stopped.
+ */
+typedef struct _persistent_header {
+
+    size_t magic;
+
+    //! offset of the first byte not yet handed out by alloc_pages()
+    size_t bump_offset;
+
+    void *root;
+
+    struct bitmap_alloc *bitmap_allocators;
+
+    size_t *occupied_words;
+
+    size_t num_bitmap_allocators;
+
+    size_t max_num_bitmap_allocators;
+
+    size_t bitmap_allocators_num_pages_allocated;
+
+    _stack free_bitmaps [BITMAP_CHUNK_MAX_SIZE - BITMAP_CHUNK_MIN_SIZE + 1];
+
+} _persistent_header;
+
+//! header of the mapped heap file, NULL if the allocator runs on anonymous memory
+_persistent_header *persistent_heap = NULL;
+
+int persistent_heap_fd = -1;
+
+size_t round_to_pages(size_t size) {
+    return (size + BITMAP_PAGE_SIZE - 1) & ~((size_t) BITMAP_PAGE_SIZE - 1);
+}
+
+/*!
+ * \brief get memory for allocator internals and slabs
+ *
+ * Anonymous mappings normally, page-aligned pieces of the heap file in persistent mode.
+ * Both are zero-filled when handed out for the first time.
+ */
+void *alloc_pages(size_t size) {
+    if(!persistent_heap)
+        return alloc_from_os(size);
+    size = round_to_pages(size);
+    if(size > PERSISTENT_SLAB_REGION_OFFSET - persistent_heap->bump_offset)
+        return NULL;
+    void *memory = ((char *) persistent_heap) + persistent_heap->bump_offset;
+    persistent_heap->bump_offset += size;
+    return memory;
+}
+
+/*!
+ * \brief give memory from alloc_pages() back
+ *
+ * In persistent mode the address range is not reused, but the file blocks are released.
+ */
+void dealloc_pages(void *memory, size_t size) {
+    if(!persistent_heap) {
+        munmap(memory, size);
+        return;
+    }
+    madvise(memory, round_to_pages(size), MADV_REMOVE);
+}
+
+void init_slab_region() {
+    if(persistent_heap) {
+        slab_region = ((char *) persistent_heap) + PERSISTENT_SLAB_REGION_OFFSET;
+        slab_region_size = BALLOC_PERSISTENT_SIZE - PERSISTENT_SLAB_REGION_OFFSET;
+        return;
+    }
+    slab_region = mmap(NULL, SLAB_REGION_SIZE, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_NORESERVE, -1, 0);
+    slab_region_size = SLAB_REGION_SIZE;
+    if(slab_region == MAP_FAILED) {
+        slab_region = NULL;
+        slab_region_size = 0;
+    }
+}
+
+/*!
+ * \brief allocate the arrays of bitmap allocators and their occupancy words
+ * \return 1 on success, 0 if alloc_pages() ran out of memory
+ */
+int init_bitmap_allocators() {
+    bitmap_allocators = alloc_pages(BITMAP_PAGE_SIZE * DYNAMIC_ARRAY_INITIAL_NUMBER_PAGES);
     num_bitmap_allocators = 0;
     max_num_bitmap_allocators = (BITMAP_PAGE_SIZE * DYNAMIC_ARRAY_INITIAL_NUMBER_PAGES) / sizeof(struct bitmap_alloc);
     bitmap_allocators_num_pages_allocated = DYNAMIC_ARRAY_INITIAL_NUMBER_PAGES;
+    occupied_words = alloc_pages(max_num_bitmap_allocators * sizeof(size_t));
+    return bitmap_allocators && occupied_words;
 }
 
-void expand_bitmap_allocators() {
-    void * new_memory = alloc_from_os(BITMAP_PAGE_SIZE * bitmap_allocators_num_pages_allocated * 2);
+/*!
+ * \brief double the arrays of bitmap allocators and their occupancy words
+ * \return 1 on success, 0 if alloc_pages() ran out of memory, the old arrays stay in use then
+ */
+int expand_bitmap_allocators() {
+    void * new_memory = alloc_pages(BITMAP_PAGE_SIZE * bitmap_allocators_num_pages_allocated * 2);
+    if(!new_memory)
+        return 0;
+    size_t *new_words = alloc_pages(max_num_bitmap_allocators * sizeof(size_t) * 2);
+    if(!new_words) {
+        dealloc_pages(new_memory, BITMAP_PAGE_SIZE * bitmap_allocators_num_pages_allocated * 2);
+        return 0;
+    }
+
     memcpy(new_memory, bitmap_allocators, BITMAP_PAGE_SIZE * bitmap_allocators_num_pages_allocated);
     #ifndef REDUCE_MUNMAP
-        munmap(bitmap_allocators, BITMAP_PAGE_SIZE * bitmap_allocators_num_pages_allocated);
+        dealloc_pages(bitmap_allocators, BITMAP_PAGE_SIZE * bitmap_allocators_num_pages_allocated);
     #endif
     bitmap_allocators = new_memory;
+
+    memcpy(new_words, occupied_words, max_num_bitmap_allocators * sizeof(size_t));
+    #ifndef REDUCE_MUNMAP
+        dealloc_pages(occupied_words, max_num_bitmap_allocators * sizeof(size_t));
+    #endif
+    occupied_words = new_words;
+
     bitmap_allocators_num_pages_allocated *= 2;
     max_num_bitmap_allocators = (bitmap_allocators_num_pages_allocated * BITMAP_PAGE_SIZE) / sizeof(struct bitmap_alloc);
+    return 1;
 }
 
-void init_stack(_stack* s) {
-    s->mem = alloc_from_os(BITMAP_PAGE_SIZE * DYNAMIC_ARRAY_INITIAL_NUMBER_PAGES);
+//! \return 1 on success, 0 if alloc_pages() ran out of memory
+int init_stack(_stack* s) {
+    s->mem = alloc_pages(BITMAP_PAGE_SIZE * DYNAMIC_ARRAY_INITIAL_NUMBER_PAGES);
     s->num_elements = 0;
     s->max_num_elements = BITMAP_PAGE_SIZE * DYNAMIC_ARRAY_INITIAL_NUMBER_PAGES / sizeof(size_t);
+    return s->mem != NULL;
 }
 
-void expand_stack(_stack* s) {
-    void * new_memory = alloc_from_os(s->max_num_elements * sizeof(size_t) * 2);
+//! \return 1 on success, 0 if alloc_pages() ran out of memory, the old stack stays in use then
+int expand_stack(_stack* s) {
+    void * new_memory = alloc_pages(s->max_num_elements * sizeof(size_t) * 2);
+    if(!new_memory)
+        return 0;
     memcpy(new_memory, s->mem, s->max_num_elements * sizeof(size_t));
     #ifndef REDUCE_MUNMAP
-        munmap(s->mem, s->max_num_elements * sizeof(size_t));
+        dealloc_pages(s->mem, s->max_num_elements * sizeof(size_t));
     #endif
     s->mem = new_memory;
     s->max_num_elements *= 2;
+    return 1;
 }
 
 #ifdef ONE_CHUNK_SIZE
-    void add_bitmap_allocator() {
-        if(num_bitmap_allocators == max_num_bitmap_allocators)
-            expand_bitmap_allocators();
+    int add_bitmap_allocator() {
+        if((num_bitmap_allocators + 1) * SLAB_STRIDE > slab_region_size)
+            return 0;
+        if(num_bitmap_allocators == max_num_bitmap_allocators && !expand_bitmap_allocators())
+            return 0;
         bitmap_allocators[num_bitmap_allocators].chunk_size = BITMAP_CHUNK_SIZE_TOTAL;
         bitmap_allocators[num_bitmap_allocators].occupied_areas = 0ull;
-        bitmap_allocators[num_bitmap_allocators].memory = mmap(NULL, BITMAP_CHUNK_SIZE_TOTAL * NUM_BITS_SIZE_T, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        bitmap_allocators[num_bitmap_allocators].touched_areas = 0ull;
+        occupied_words[num_bitmap_allocators] = 0ull;
+        bitmap_allocators[num_bitmap_allocators].memory = slab_region + num_bitmap_allocators * SLAB_STRIDE;
         free_bitmaps->mem[free_bitmaps->num_elements] = num_bitmap_allocators;
         free_bitmaps->num_elements++;
         num_bitmap_allocators++;
+        return 1;
     }
 #else
-    void add_bitmap_allocator(int chunk_size_index) {
-        if(num_bitmap_allocators == max_num_bitmap_allocators)
-            expand_bitmap_allocators();
+    int add_bitmap_allocator(int chunk_size_index) {
+        if((num_bitmap_allocators + 1) * SLAB_STRIDE > slab_region_size)
+            return 0;
+        if(num_bitmap_allocators == max_num_bitmap_allocators && !expand_bitmap_allocators())
+            return 0;
     
         size_t chunk_size = 1ull << (chunk_size_index + BITMAP_CHUNK_MIN_SIZE);
         struct bitmap_alloc * to_add = bitmap_allocators + num_bitmap_allocators;
         to_add->chunk_size = chunk_size;
         to_add->occupied_areas = 0ull;
-        to_add->memory = alloc_from_os(chunk_size * NUM_BITS_SIZE_T);
+        to_add->touched_areas = 0ull;
+        occupied_words[num_bitmap_allocators] = 0ull;
+        to_add->memory = slab_region + num_bitmap_allocators * SLAB_STRIDE;
         num_bitmap_allocators++;
 
         free_bitmaps[chunk_size_index].mem[free_bitmaps[chunk_size_index].num_elements] = num_bitmap_allocators - 1;
         free_bitmaps[chunk_size_index].num_elements++;
+        return 1;
     }
 #endif
 
 
+/*!
+ * \brief set up the allocator state in the slab region and memory from alloc_pages()
+ * \return 1 on success, 0 if some memory could not be allocated
+ */
 #ifdef ONE_CHUNK_SIZE
-    void balloc_setup(void) {
-        init_bitmap_allocators();
-        init_stack(free_bitmaps);
+    int setup_allocator_state(void) {
+        init_slab_region();
+        if(!slab_region || !init_bitmap_allocators() || !init_stack(free_bitmaps))
+            return 0;
         for(int j = 0; j < INITIAL_NUMBER_BITMAP_ALLOCATORS_PER_SIZE; j++) {
             add_bitmap_allocator();
         }
+        return 1;
     }
 #else
-    void balloc_setup(void) {
-        init_bitmap_allocators();
+    int setup_allocator_state(void) {
+        init_slab_region();
+        if(!slab_region || !init_bitmap_allocators())
+            return 0;
         for(int i = 0; i < (BITMAP_CHUNK_MAX_SIZE - BITMAP_CHUNK_MIN_SIZE + 1); i++) {
-            init_stack(free_bitmaps + i);
+            if(!init_stack(free_bitmaps + i))
+                return 0;
             for(int j = 0; j < INITIAL_NUMBER_BITMAP_ALLOCATORS_PER_SIZE; j++) {
                 add_bitmap_allocator(i);
             }
         }
+        return 1;
     }
 #endif
 
+void balloc_setup(void) {
+    setup_allocator_state();
+}
+
+/*!
+ * \brief store the allocator state in the heap file and unmap it
+ */
+void persistent_heap_close(void) {
+    persistent_heap->bitmap_allocators = bitmap_allocators;
+    persistent_heap->occupied_words = occupied_words;
+    persistent_heap->num_bitmap_allocators = num_bitmap_allocators;
+    persistent_heap->max_num_bitmap_allocators = max_num_bitmap_allocators;
+    persistent_heap->bitmap_allocators_num_pages_allocated = bitmap_allocators_num_pages_allocated;
+    memcpy(persistent_heap->free_bitmaps, free_bitmaps, sizeof(free_bitmaps));
+    persistent_heap->magic = BALLOC_PERSISTENT_MAGIC;
+    munmap(persistent_heap, BALLOC_PERSISTENT_SIZE);
+    close(persistent_heap_fd);
+    persistent_heap = NULL;
+    persistent_heap_fd = -1;
+    slab_region = NULL;
+    slab_region_size = 0;
+    bitmap_allocators = NULL;
+    occupied_words = NULL;
+    num_bitmap_allocators = 0ull;
+}
+
+int balloc_setup_persistent(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT, 0600);
+    if(fd < 0)
+        return -1;
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) || (file_stat.st_size && (size_t) file_stat.st_size != BALLOC_PERSISTENT_SIZE)) {
+        close(fd);
+        return -1;
+    }
+    int fresh = !file_stat.st_size;
+    //the file stays sparse, blocks are only allocated for pages that get written
+    if(fresh && ftruncate(fd, BALLOC_PERSISTENT_SIZE)) {
+        close(fd);
+        return -1;
+    }
+    void *heap = mmap(BALLOC_PERSISTENT_BASE, BALLOC_PERSISTENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+    if(heap == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+    if(heap != BALLOC_PERSISTENT_BASE) {
+        //kernels without MAP_FIXED_NOREPLACE treat the address as a hint only
+        munmap(heap, BALLOC_PERSISTENT_SIZE);
+        close(fd);
+        return -1;
+    }
+    persistent_heap = heap;
+    persistent_heap_fd = fd;
+
+    if(fresh) {
+        persistent_heap->bump_offset = BITMAP_PAGE_SIZE;
+        persistent_heap->root = NULL;
+        if(!setup_allocator_state()) {
+            munmap(heap, BALLOC_PERSISTENT_SIZE);
+            close(fd);
+            persistent_heap = NULL;
+            persistent_heap_fd = -1;
+            slab_region = NULL;
+            slab_region_size = 0;
+            bitmap_allocators = NULL;
+            occupied_words = NULL;
+            num_bitmap_allocators = 0ull;
+            return -1;
+        }
+        return 0;
+    }
+    if(persistent_heap->magic != BALLOC_PERSISTENT_MAGIC) {
+        munmap(heap, BALLOC_PERSISTENT_SIZE);
+        close(fd);
+        persistent_heap = NULL;
+        persistent_heap_fd = -1;
+        return -1;
+    }
+    init_slab_region();
+    bitmap_allocators = persistent_heap->bitmap_allocators;
+    occupied_words = persistent_heap->occupied_words;
+    num_bitmap_allocators = persistent_heap->num_bitmap_allocators;
+    max_num_bitmap_allocators = persistent_heap->max_num_bitmap_allocators;
+    bitmap_allocators_num_pages_allocated = persistent_heap->bitmap_allocators_num_pages_allocated;
+    memcpy(free_bitmaps, persistent_heap->free_bitmaps, sizeof(free_bitmaps));
+    //the state lives in globals until teardown, a crash must not leave a heap that looks valid
+    persistent_heap->magic = 0;
+    return 0;
+}
+
+void balloc_set_root(void *root) {
+    if(persistent_heap)
+        persistent_heap->root = root;
+}
+
+void *balloc_get_root(void) {
+    return persistent_heap ? persistent_heap->root : NULL;
+}
+
 #ifdef ONE_CHUNK_SIZE
     void balloc_teardown(void) {
-        for(size_t i = 0; i < num_bitmap_allocators; i++) {
-            munmap(bitmap_allocators[i].memory, BITMAP_CHUNK_SIZE_TOTAL * NUM_BITS_SIZE_T);
+        if(persistent_heap) {
+            persistent_heap_close();
+            return;
         }
+        munmap(slab_region, slab_region_size);
+        slab_region = NULL;
+        slab_region_size = 0;
         munmap(bitmap_allocators, BITMAP_PAGE_SIZE * bitmap_allocators_num_pages_allocated);
+        munmap(occupied_words, max_num_bitmap_allocators * sizeof(size_t));
         #ifndef REDUCE_MUNMAP
             munmap(free_bitmaps->mem, free_bitmaps->max_num_elements * sizeof(size_t));
         #endif
         bitmap_allocators = NULL;
+        occupied_words = NULL;
         num_bitmap_allocators = 0ull;
     }
 #else
     void balloc_teardown(void) {
-        for(size_t i = 0; i < num_bitmap_allocators; i++) {
-            if(bitmap_allocators[i].chunk_size)
-                munmap(bitmap_allocators[i].memory, bitmap_allocators[i].chunk_size * NUM_BITS_SIZE_T);
+        if(persistent_heap) {
+            persistent_heap_close();
+            return;
         }
+        munmap(slab_region, slab_region_size);
+        slab_region = NULL;
+        slab_region_size = 0;
         munmap(bitmap_allocators, BITMAP_PAGE_SIZE * bitmap_allocators_num_pages_allocated);
+        munmap(occupied_words, max_num_bitmap_allocators * sizeof(size_t));
         #ifndef REDUCE_MUNMAP
             for(int i = 0; i < (BITMAP_CHUNK_MAX_SIZE - BITMAP_CHUNK_MIN_SIZE + 1); i++) {
                 munmap(free_bitmaps[i].mem, free_bitmaps[i].max_num_elements * sizeof(size_t));
             }
         #endif
         bitmap_allocators = NULL;
+        occupied_words = NULL;
         num_bitmap_allocators = 0ull;
     }
 #endif
@@ -203,56 +475,104 @@ void dealloc_to_os(void *memory, size_t size) {
     munmap(memory, size);
 }
 
+/*!
+ * \brief pop all full bitmap allocators from the top of a free stack
+ *
+ * Deallocations push an allocator once per freed chunk, so the stack can hold many
+ * entries of allocators that were filled up through another entry. Their occupancy
+ * words are gathered from occupied_words and compared against all ones, 8 (AVX-512)
+ * or 4 (AVX2) entries per instruction.
+ */
+void drop_full_bitmaps(_stack *s) {
+    size_t n = s->num_elements;
+#if defined(__AVX512F__)
+    const __m512i all_ones = _mm512_set1_epi64(-1);
+    while(n >= 8) {
+        __m512i indices = _mm512_loadu_si512(s->mem + n - 8);
+        __m512i words = _mm512_i64gather_epi64(indices, occupied_words, 8);
+        unsigned not_full = _mm512_cmpneq_epi64_mask(words, all_ones);
+        if(not_full) {
+            //keep everything up to the topmost allocator with a free chunk
+            s->num_elements = n - 8 + (CHAR_BIT * sizeof(unsigned) - __builtin_clz(not_full));
+            return;
+        }
+        n -= 8;
+    }
+#elif defined(__AVX2__)
+    const __m256i all_ones = _mm256_set1_epi64x(-1);
+    while(n >= 4) {
+        __m256i indices = _mm256_loadu_si256((const __m256i *) (s->mem + n - 4));
+        __m256i words = _mm256_i64gather_epi64((const long long *) occupied_words, indices, 8);
+        unsigned not_full = ~_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(words, all_ones))) & 0xfu;
+        if(not_full) {
+            s->num_elements = n - 4 + (CHAR_BIT * sizeof(unsigned) - __builtin_clz(not_full));
+            return;
+        }
+        n -= 4;
+    }
+#endif
+    while(n && !(~occupied_words[s->mem[n - 1]]))
+        n--;
+    s->num_elements = n;
+}
+
 #ifdef ONE_CHUNK_SIZE
-void *alloc(size_t size) {
+void *alloc_chunk(size_t size, int zeroed) {
     if(!size)
         return NULL;
-    size += sizeof(balloc_metadata);
 
     if(size > BITMAP_CHUNK_SIZE_TOTAL) {
-        //OS Allocation
-        void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
-        *((balloc_metadata *) memory) = BALLOC_METADATA_OS_ALLOCATION | size;
+        //OS Allocation, fresh mappings are zero-filled by the kernel
+        void *memory = alloc_pages(size + sizeof(balloc_metadata));
+        if(!memory)
+            return NULL;
+        *((balloc_metadata *) memory) = size + sizeof(balloc_metadata);
         return ((char *) memory) + sizeof(balloc_metadata);
     }
 
     //BitMap Allocation
     while(1) {
         if(!free_bitmaps->num_elements) {
-            //Init a new bitmap allocator.
-            add_bitmap_allocator();
+            //Init a new bitmap allocator, its memory was never touched.
+            if(!add_bitmap_allocator())
+                return NULL;
+            occupied_words[num_bitmap_allocators - 1] = 1llu;
             bitmap_allocators[num_bitmap_allocators - 1].occupied_areas = 1llu;
-            *((balloc_metadata *) bitmap_allocators[num_bitmap_allocators - 1].memory) = (~BALLOC_METADATA_OS_ALLOCATION) & (num_bitmap_allocators - 1);
-            return ((char *) bitmap_allocators[num_bitmap_allocators - 1].memory) + sizeof(balloc_metadata);
+            bitmap_allocators[num_bitmap_allocators - 1].touched_areas = 1llu;
+            return bitmap_allocators[num_bitmap_allocators - 1].memory;
         }
 
         size_t curr_allocator_index = free_bitmaps->mem[free_bitmaps->num_elements - 1];
-        if(!(~(bitmap_allocators[curr_allocator_index].occupied_areas))) {
-            (free_bitmaps->num_elements)--;
+        if(!(~occupied_words[curr_allocator_index])) {
+            drop_full_bitmaps(free_bitmaps);
             continue;
         }
-        size_t pos_in_bitmap_allocator = __builtin_ffsll(~(bitmap_allocators[curr_allocator_index].occupied_areas)) - 1;
-        bitmap_allocators[curr_allocator_index].occupied_areas |= 1llu << pos_in_bitmap_allocator;
-        if(!(~(bitmap_allocators[curr_allocator_index].occupied_areas))) {
+        size_t pos_in_bitmap_allocator = __builtin_ffsll(~occupied_words[curr_allocator_index]) - 1;
+        occupied_words[curr_allocator_index] |= 1llu << pos_in_bitmap_allocator;
+        bitmap_allocators[curr_allocator_index].occupied_areas = occupied_words[curr_allocator_index];
+        if(!(~occupied_words[curr_allocator_index])) {
             (free_bitmaps->num_elements)--;
         }
         void *memory = ((char *) bitmap_allocators[curr_allocator_index].memory) + pos_in_bitmap_allocator * BITMAP_CHUNK_SIZE_TOTAL;
-        *((balloc_metadata *) memory) = (~BALLOC_METADATA_OS_ALLOCATION) & curr_allocator_index;
-        return ((char *) memory) + sizeof(balloc_metadata);
+        if(zeroed && (bitmap_allocators[curr_allocator_index].touched_areas & (1llu << pos_in_bitmap_allocator)))
+            memset(memory, 0, size);
+        bitmap_allocators[curr_allocator_index].touched_areas |= 1llu << pos_in_bitmap_allocator;
+        return memory;
     }
 }
 #else
-void *alloc(size_t size) {
+void *alloc_chunk(size_t size, int zeroed) {
     if(!size)
         return NULL;
-    size += sizeof(balloc_metadata);
-    int chunk_size_index = NUM_BITS_SIZE_T - __builtin_clzl(size - 1);
+    int chunk_size_index = size > 1 ? (int) (NUM_BITS_SIZE_T - __builtin_clzl(size - 1)) : 0;
     void * memory;
 
     if(chunk_size_index > BITMAP_CHUNK_MAX_SIZE) {
-        //OS Allocation
-        memory = alloc_from_os(size);
-        *((balloc_metadata *) memory) = BALLOC_METADATA_OS_ALLOCATION | size;
+        //OS Allocation, fresh mappings are zero-filled by the kernel
+        memory = alloc_pages(size + sizeof(balloc_metadata));
+        if(!memory)
+            return NULL;
+        *((balloc_metadata *) memory) = size + sizeof(balloc_metadata);
         return ((char *) memory) + sizeof(balloc_metadata);
     }
 
@@ -262,66 +582,107 @@ void *alloc(size_t size) {
 
     while(1) {
         if(!free_bitmap->num_elements) {
-            //Init a new bitmap allocator.
-            add_bitmap_allocator(chunk_size_index);
+            //Init a new bitmap allocator, its memory was never touched.
+            if(!add_bitmap_allocator(chunk_size_index))
+                return NULL;
+            occupied_words[num_bitmap_allocators - 1] = 1llu;
             bitmap_allocators[num_bitmap_allocators - 1].occupied_areas = 1llu;
-            *((balloc_metadata *) bitmap_allocators[num_bitmap_allocators - 1].memory) = (~BALLOC_METADATA_OS_ALLOCATION) & (num_bitmap_allocators - 1);
-            return ((char *) bitmap_allocators[num_bitmap_allocators - 1].memory) + sizeof(balloc_metadata);
+            bitmap_allocators[num_bitmap_allocators - 1].touched_areas = 1llu;
+            return bitmap_allocators[num_bitmap_allocators - 1].memory;
         }
 
         size_t curr_allocator_index = free_bitmap->mem[free_bitmap->num_elements - 1];
-        if(!(~(bitmap_allocators[curr_allocator_index].occupied_areas))) {
-            (free_bitmap->num_elements)--;
+        if(!(~occupied_words[curr_allocator_index])) {
+            drop_full_bitmaps(free_bitmap);
             continue;
         }
-        size_t pos_in_bitmap_allocator = __builtin_ffsll(~(bitmap_allocators[curr_allocator_index].occupied_areas)) - 1;
-        bitmap_allocators[curr_allocator_index].occupied_areas |= 1llu << pos_in_bitmap_allocator;
-        if(!(~(bitmap_allocators[curr_allocator_index].occupied_areas))) {
+        size_t pos_in_bitmap_allocator = __builtin_ffsll(~occupied_words[curr_allocator_index]) - 1;
+        occupied_words[curr_allocator_index] |= 1llu << pos_in_bitmap_allocator;
+        bitmap_allocators[curr_allocator_index].occupied_areas = occupied_words[curr_allocator_index];
+        if(!(~occupied_words[curr_allocator_index])) {
             (free_bitmap->num_elements)--;
         }
         memory = ((char *) bitmap_allocators[curr_allocator_index].memory) + pos_in_bitmap_allocator * bitmap_allocators[curr_allocator_index].chunk_size;
-        *((balloc_metadata *) memory) = (~BALLOC_METADATA_OS_ALLOCATION) & curr_allocator_index;
-        return ((char *) memory) + sizeof(balloc_metadata);
+        if(zeroed && (bitmap_allocators[curr_allocator_index].touched_areas & (1llu << pos_in_bitmap_allocator)))
+            memset(memory, 0, size);
+        bitmap_allocators[curr_allocator_index].touched_areas |= 1llu << pos_in_bitmap_allocator;
+        return memory;
     }
 }
 #endif
 
+void *alloc(size_t size) {
+    return alloc_chunk(size, 0);
+}
+
+void *alloc_zeroed(size_t size) {
+    return alloc_chunk(size, 1);
+}
+
 #ifdef ONE_CHUNK_SIZE
+/*!
+ * \brief free a chunk, its bitmap allocator is found through the offset in the slab region
+ */
+void dealloc_in_slab(size_t offset) {
+    size_t allocator_index = offset / SLAB_STRIDE;
+    occupied_words[allocator_index] &= ~(1llu << ((offset % SLAB_STRIDE) / BITMAP_CHUNK_SIZE_TOTAL));
+    bitmap_allocators[allocator_index].occupied_areas = occupied_words[allocator_index];
+    //without room on the stack the chunk is still free, it is found again once its allocator gets pushed
+    if(free_bitmaps->num_elements == free_bitmaps->max_num_elements && !expand_stack(free_bitmaps))
+        return;
+    free_bitmaps->mem[free_bitmaps->num_elements] = allocator_index;
+    (free_bitmaps->num_elements)++;
+}
+#else
+void dealloc_in_slab(size_t offset) {
+    size_t allocator_index = offset / SLAB_STRIDE;
+    occupied_words[allocator_index] &= ~(1llu << ((offset % SLAB_STRIDE) / bitmap_allocators[allocator_index].chunk_size));
+    bitmap_allocators[allocator_index].occupied_areas = occupied_words[allocator_index];
+    int chunk_size_index = NUM_BITS_SIZE_T - BITMAP_CHUNK_MIN_SIZE - 1 - __builtin_clzl(bitmap_allocators[allocator_index].chunk_size);
+    //without room on the stack the chunk is still free, it is found again once its allocator gets pushed
+    if(free_bitmaps[chunk_size_index].num_elements == free_bitmaps[chunk_size_index].max_num_elements && !expand_stack(free_bitmaps + chunk_size_index))
+        return;
+    free_bitmaps[chunk_size_index].mem[free_bitmaps[chunk_size_index].num_elements] = allocator_index;
+    (free_bitmaps[chunk_size_index].num_elements)++;
+}
+#endif
+
 void dealloc(void *memory) {
     if(!memory)
         return;
-    void *real_start = ((balloc_metadata *) memory) - 1;
-    balloc_metadata hat = *((balloc_metadata *) real_start);
-    if(hat & BALLOC_METADATA_OS_ALLOCATION) {
+    size_t offset = (size_t) ((uintptr_t) memory - (uintptr_t) slab_region);
+    if(offset < slab_region_size) {
+        //BitMap Deallocation
+        dealloc_in_slab(offset);
+        return;
+    }
+    //OS Deallocation
+    balloc_metadata *real_start = ((balloc_metadata *) memory) - 1;
+    dealloc_pages(real_start, *real_start);
+}
+
+#ifdef ONE_CHUNK_SIZE
+void dealloc_sized(void *memory, size_t size) {
+    if(!memory)
+        return;
+    if(size > BITMAP_CHUNK_SIZE_TOTAL) {
         //OS Deallocation
-        munmap(real_start, (~BALLOC_METADATA_OS_ALLOCATION) & hat);
+        dealloc_pages(((balloc_metadata *) memory) - 1, size + sizeof(balloc_metadata));
         return;
     }
     //BitMap Deallocation
-    bitmap_allocators[hat].occupied_areas &= ~(1llu << (((size_t) ((char *) real_start - (char *) bitmap_allocators[hat].memory)) / BITMAP_CHUNK_SIZE_TOTAL));
-    if(free_bitmaps->num_elements == free_bitmaps->max_num_elements)
-        expand_stack(free_bitmaps);
-    free_bitmaps->mem[free_bitmaps->num_elements] = hat;
-    (free_bitmaps->num_elements)++;
+    dealloc_in_slab((size_t) ((uintptr_t) memory - (uintptr_t) slab_region));
 }
 #else
-void dealloc(void *memory) {
+void dealloc_sized(void *memory, size_t size) {
     if(!memory)
         return;
-    void *real_start = ((balloc_metadata *) memory) - 1;
-    balloc_metadata hat = *((balloc_metadata *) real_start);
-    if(hat & BALLOC_METADATA_OS_ALLOCATION) {
+    if(size > 1 && (int) (NUM_BITS_SIZE_T - __builtin_clzl(size - 1)) > BITMAP_CHUNK_MAX_SIZE) {
         //OS Deallocation
-        munmap(real_start, (~BALLOC_METADATA_OS_ALLOCATION) & hat);
+        dealloc_pages(((balloc_metadata *) memory) - 1, size + sizeof(balloc_metadata));
         return;
     }
     //BitMap Deallocation
-    bitmap_allocators[hat].occupied_areas &= ~(1llu << (((size_t) ((char *) real_start - (char *) bitmap_allocators[hat].memory)) / bitmap_allocators[hat].chunk_size));
-    int chunk_size_index = NUM_BITS_SIZE_T - BITMAP_CHUNK_MIN_SIZE - 1 - __builtin_clzl(bitmap_allocators[hat].chunk_size);
-    if(free_bitmaps[chunk_size_index].num_elements == free_bitmaps[chunk_size_index].max_num_elements)
-        expand_stack(free_bitmaps + chunk_size_index);
-    free_bitmaps[chunk_size_index].mem[free_bitmaps[chunk_size_index].num_elements] = hat;
-    (free_bitmaps[chunk_size_index].num_elements)++;
+    dealloc_in_slab((size_t) ((uintptr_t) memory - (uintptr_t) slab_region));
 }
 #endif
-
@@ -99,6 +99,46 @@ TEST(AllocatorState, OccupiedBitsTracking) {
     balloc_teardown();
 }
 
+TEST(AllocatorState, OccupiedWordsMatchBitmaps) {
+    balloc_setup();
+
+    // the dense occupied_words array and the occupied_areas fields describe the same chunks
+    auto expect_words_match = [](const char *when) {
+        for (size_t i = 0; i < num_bitmap_allocators; i++) {
+            EXPECT_EQ(occupied_words[i], bitmap_allocators[i].occupied_areas)
+                << "allocator " << i << " " << when;
+        }
+    };
+
+    std::vector<void*> allocations;
+    for (int i = 0; i < 200; i++) {
+        void* result = alloc(8 + (i % 8) * 8);
+        ASSERT_TRUE(result);
+        allocations.push_back(result);
+    }
+    expect_words_match("after allocation");
+
+    size_t occupied = 0;
+    for (size_t i = 0; i < num_bitmap_allocators; i++)
+        occupied += __builtin_popcountl(occupied_words[i]);
+    EXPECT_GE(occupied, allocations.size());
+
+    for (size_t i = 0; i < allocations.size(); i += 2)
+        dealloc(allocations[i]);
+    expect_words_match("after deallocating every second chunk");
+
+    size_t still_occupied = 0;
+    for (size_t i = 0; i < num_bitmap_allocators; i++)
+        still_occupied += __builtin_popcountl(occupied_words[i]);
+    EXPECT_EQ(occupied - still_occupied, allocations.size() / 2);
+
+    for (size_t i = 1; i < allocations.size(); i += 2)
+        dealloc(allocations[i]);
+    expect_words_match("after deallocating everything");
+
+    balloc_teardown();
+}
+
 // ===== ALLOCATION PATTERNS TESTS =====
 // Tests that verify complex allocation/deallocation patterns
 
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+extern "C" {
+#include "balloc.h"
+}
+
+struct node {
+    node *next;
+    size_t value;
+};
+
+class PersistentHeap : public ::testing::Test {
+  protected:
+    std::string path;
+
+    void SetUp() override {
+        path = "balloc_persistent_test_" + std::to_string(getpid()) + ".heap";
+        unlink(path.c_str());
+    }
+
+    void TearDown() override {
+        unlink(path.c_str());
+    }
+};
+
+TEST_F(PersistentHeap, SetupAndTeardown) {
+    ASSERT_EQ(balloc_setup_persistent(path.c_str()), 0);
+    void *memory = alloc(16);
+    ASSERT_TRUE(memory);
+    EXPECT_GE(memory, BALLOC_PERSISTENT_BASE);
+    EXPECT_LT(memory, static_cast<char *>(BALLOC_PERSISTENT_BASE) + BALLOC_PERSISTENT_SIZE);
+    dealloc(memory);
+    balloc_teardown();
+
+    EXPECT_EQ(bitmap_allocators, nullptr) << "after teardown, everything should be zeroed";
+    EXPECT_EQ(num_bitmap_allocators, 0);
+    EXPECT_EQ(balloc_get_root(), nullptr);
+}
+
+TEST_F(PersistentHeap, ObjectsSurviveReopen) {
+    constexpr size_t num_nodes = 10000;
+
+    ASSERT_EQ(balloc_setup_persistent(path.c_str()), 0);
+    node *head = nullptr;
+    for (size_t i = 0; i < num_nodes; i++) {
+        node *n = static_cast<node *>(alloc(sizeof(node)));
+        ASSERT_TRUE(n);
+        n->next  = head;
+        n->value = i;
+        head     = n;
+    }
+    // large blocks live in the heap file as well
+    size_t *large = static_cast<size_t *>(alloc(100000 * sizeof(size_t)));
+    ASSERT_TRUE(large);
+    for (size_t i = 0; i < 100000; i++) large[i] = i * i;
+    head->value = reinterpret_cast<size_t>(large);
+    balloc_set_root(head);
+    balloc_teardown();
+
+    ASSERT_EQ(balloc_setup_persistent(path.c_str()), 0);
+    head = static_cast<node *>(balloc_get_root());
+    ASSERT_TRUE(head);
+    large = reinterpret_cast<size_t *>(head->value);
+    for (size_t i = 0; i < 100000; i++) ASSERT_EQ(large[i], i * i);
+    size_t expected = num_nodes - 2;
+    for (node *n = head->next; n; n = n->next, expected--) ASSERT_EQ(n->value, expected);
+    EXPECT_EQ(expected, static_cast<size_t>(-1));
+
+    // the reopened heap keeps allocating without handing out live memory again
+    node *extra = static_cast<node *>(alloc(sizeof(node)));
+    ASSERT_TRUE(extra);
+    for (node *n = head; n; n = n->next) ASSERT_NE(n, extra);
+
+    // and frees work on blocks from the earlier session
+    dealloc(large);
+    while (head) {
+        node *next = head->next;
+        dealloc(head);
+        head = next;
+    }
+    dealloc(extra);
+    balloc_teardown();
+}
+
+TEST_F(PersistentHeap, RejectsForeignFiles) {
+    FILE *file = fopen(path.c_str(), "w");
+    ASSERT_TRUE(file);
+    fputs("this is not a heap", file);
+    fclose(file);
+
+    EXPECT_EQ(balloc_setup_persistent(path.c_str()), -1);
+    EXPECT_EQ(bitmap_allocators, nullptr);
+}
+
+TEST_F(PersistentHeap, NormalSetupStillWorks) {
+    ASSERT_EQ(balloc_setup_persistent(path.c_str()), 0);
+    balloc_teardown();
+
+    balloc_setup();
+    void *memory = alloc(16);
+    ASSERT_TRUE(memory);
+    EXPECT_EQ(balloc_get_root(), nullptr);
+    dealloc(memory);
+    balloc_teardown();
+}
+
+TEST_F(PersistentHeap, ExhaustedHeapFailsAllocations) {
+    ASSERT_EQ(balloc_setup_persistent(path.c_str()), 0);
+    // use up the part of the heap file that holds large blocks and the allocator arrays,
+    // large blocks only write their size, so the file stays sparse
+    for (size_t size = 1ull << 30; size > 64; size /= 2)
+        while (alloc(size)) {}
+    EXPECT_EQ(alloc(65), nullptr);
+
+    // small chunks fail once the arrays of bitmap allocators cannot grow any more
+    std::vector<void *> chunks;
+    while (void *chunk = alloc(16)) chunks.push_back(chunk);
+    EXPECT_GT(chunks.size(), 0u);
+    EXPECT_EQ(alloc(16), nullptr);
+
+    // frees beyond what the free stack can hold still work, and the chunks get reused
+    for (void *chunk : chunks) dealloc(chunk);
+    void *reused = alloc(16);
+    ASSERT_TRUE(reused);
+    EXPECT_GE(reused, BALLOC_PERSISTENT_BASE);
+    EXPECT_LT(reused, static_cast<char *>(BALLOC_PERSISTENT_BASE) + BALLOC_PERSISTENT_SIZE);
+    dealloc(reused);
+    balloc_teardown();
+}
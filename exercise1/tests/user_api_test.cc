@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <cstring>
 #include <random>
 #include <set>
 
@@ -6,6 +7,19 @@ extern "C" {
 #include "balloc.h"
 }
 
+#ifdef BALLOC_REQUIRED_ISA
+// builds of this test for a vector extension are skipped on cpus without it
+class RequiredIsa : public ::testing::Environment {
+  public:
+    void SetUp() override {
+        if (!__builtin_cpu_supports(BALLOC_REQUIRED_ISA))
+            GTEST_SKIP() << "cpu does not support " BALLOC_REQUIRED_ISA;
+    }
+};
+
+static ::testing::Environment *const required_isa = ::testing::AddGlobalTestEnvironment(new RequiredIsa);
+#endif
+
 TEST(UserAPI, BasicAllocation) {
     balloc_setup();
     void* result = alloc(8);
@@ -280,3 +294,109 @@ TEST(UserAPI, EdgeCases) {
     }
     balloc_teardown();
 }
+
+TEST(UserAPI, ZeroedAllocation) {
+    balloc_setup();
+    std::vector<size_t> sizes = {1, 8, 16, 56, 64, 1000, 4096, 10000};
+
+    for (size_t size : sizes) {
+        // dirty a block first, so the zeroed allocation may get it back
+        unsigned char *dirty = reinterpret_cast<unsigned char *>(alloc(size));
+        ASSERT_TRUE(dirty);
+        memset(dirty, 0xAB, size);
+        dealloc(dirty);
+
+        unsigned char *memory = reinterpret_cast<unsigned char *>(alloc_zeroed(size));
+        ASSERT_TRUE(memory) << "Failed to allocate " << size << " zeroed bytes";
+        for (size_t i = 0; i < size; i++) {
+            ASSERT_EQ(memory[i], 0) << "byte " << i << " of " << size << " is not zeroed";
+        }
+        dealloc(memory);
+    }
+
+    // untouched chunks of fresh bitmap allocators have to be zero as well
+    std::vector<void *> allocations;
+    for (int i = 0; i < 1000; i++) {
+        unsigned char *memory = reinterpret_cast<unsigned char *>(alloc_zeroed(32));
+        ASSERT_TRUE(memory);
+        for (size_t j = 0; j < 32; j++) {
+            ASSERT_EQ(memory[j], 0);
+        }
+        memset(memory, 0xCD, 32);
+        allocations.push_back(memory);
+    }
+    for (void *ptr : allocations) {
+        dealloc(ptr);
+    }
+    EXPECT_FALSE(alloc_zeroed(0));
+    balloc_teardown();
+}
+
+TEST(UserAPI, SizedDeallocation) {
+    balloc_setup();
+    std::vector<size_t> sizes = {1, 8, 16, 63, 64, 65, 1000, 4096, 10000};
+
+    for (size_t size : sizes) {
+        void *first = alloc(size);
+        ASSERT_TRUE(first);
+        memset(first, 0x5A, size);
+        dealloc_sized(first, size);
+
+        // small blocks are reused right away after a sized free
+        void *second = alloc(size);
+        ASSERT_TRUE(second);
+        if (size <= 64) {
+            EXPECT_EQ(first, second);
+        }
+        memset(second, 0xA5, size);
+        dealloc_sized(second, size);
+    }
+
+    // sized and unsized frees can be mixed
+    std::vector<void *> allocations;
+    for (int i = 0; i < 1000; i++) {
+        allocations.push_back(alloc(24));
+        ASSERT_TRUE(allocations.back());
+    }
+    for (int i = 0; i < 1000; i++) {
+        if (i % 2)
+            dealloc_sized(allocations[i], 24);
+        else
+            dealloc(allocations[i]);
+    }
+    dealloc_sized(nullptr, 16); // Should not crash
+    balloc_teardown();
+}
+
+TEST(UserAPI, SkipFullSlabsOnFreeStack) {
+    balloc_setup();
+    // 40 slabs of 64 chunks, filled one after another
+    constexpr size_t num_slabs = 40, chunks_per_slab = NUM_BITS_SIZE_T, middle = 13;
+    std::vector<void *> chunks;
+    for (size_t i = 0; i < num_slabs * chunks_per_slab; i++) {
+        chunks.push_back(alloc(16));
+        ASSERT_TRUE(chunks.back());
+    }
+    auto chunk = [&](size_t slab, size_t index) { return chunks[slab * chunks_per_slab + index]; };
+
+    // every slab is pushed twice, except the middle one which is pushed once
+    for (size_t slab = 0; slab < num_slabs; slab++)
+        dealloc(chunk(slab, 0));
+    for (size_t slab = 0; slab < num_slabs; slab++)
+        if (slab != middle)
+            dealloc(chunk(slab, 1));
+    // refilling takes the second entries, which leaves the first entries of all slabs
+    // above the middle one full on the stack, more than one gather width of them
+    for (size_t slab = num_slabs; slab-- > 0;) {
+        if (slab == middle)
+            continue;
+        for (int i = 0; i < 2; i++) {
+            void *memory = alloc(16);
+            EXPECT_TRUE(memory == chunk(slab, 0) || memory == chunk(slab, 1));
+        }
+    }
+
+    // the full entries are skipped and the free chunk of the middle slab is reused
+    EXPECT_EQ(alloc(16), chunk(middle, 0));
+    balloc_teardown();
+}
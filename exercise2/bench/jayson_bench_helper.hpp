@@ -4,6 +4,7 @@
 #include <string>
 #include <random>
 #include <array>
+#include <vector>
 #include <sstream>
 #include <cassert>
 
@@ -27,6 +28,18 @@ inline std::string make_test_string(const std::string &base, std::size_t target_
     return result;
 }
 
+// Helper function to repeat a value as the elements of one array document of about target size
+inline std::string make_test_document(const std::string &base, std::size_t target_size = bench_bytes) {
+    std::string result = "[";
+    result.reserve(target_size + base.size() + 2);
+    while (result.size() < target_size) {
+        if (result.size() > 1) result += ',';
+        result += base;
+    }
+    result += ']';
+    return result;
+}
+
 // Random generators with fixed seeds for reproducibility
 inline std::mt19937 get_generator() {
     return std::mt19937(42); // Fixed seed for reproducibility
@@ -142,6 +155,19 @@ inline std::string generate_random_object(size_t num_keys) {
     return ss.str();
 }
 
+// Helper function to generate newline-delimited records; the generators are seeded, so records with the same
+// number of keys repeat
+inline std::string generate_ndjson(size_t count, size_t max_keys = 8) {
+    std::vector<std::string> records;
+    for (size_t keys = 1; keys <= max_keys; ++keys) records.push_back(generate_random_object(keys));
+    std::string result;
+    for (size_t i = 0; i < count; ++i) {
+        result += records[i % max_keys];
+        result += '\n';
+    }
+    return result;
+}
+
 // Generate random JSON arrays
 inline std::string generate_random_array(size_t num_elements) {
     auto gen = get_generator();
@@ -1,14 +1,52 @@
 #include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <new>
 #include <string>
 #include <sstream>
 #include <fstream>
 
 #include "jayson.hpp"
 #include "jayson_fixed.hpp"
+#include "jayson_file.hpp"
+#include "jayson_dump.hpp"
+#include "jayson_tape.hpp"
+#include "jayson_lazy.hpp"
+#include "jayson_events.hpp"
+#include "jayson_feed.hpp"
+#include "jayson_ndjson.hpp"
 #include "jayson_bench_helper.hpp"
 
 using namespace jayson::bench;
 
+// Counts heap allocations so that benchmarks can report them per parse. The replacement operators
+// forward to malloc/free, which GCC cannot tell apart from a mismatched new/free pair.
+static std::size_t allocation_count = 0;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void *operator new(std::size_t size) {
+    allocation_count++;
+    if (void *p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#pragma GCC diagnostic pop
+
+static void report_allocations(benchmark::State &state, std::size_t allocations_before) {
+    state.counters["allocs_per_parse"] = static_cast<double>(allocation_count - allocations_before) /
+                                         static_cast<double>(state.iterations());
+}
+
 //------------------------------------------------------------------------------
 // BASIC VALUE TYPE BENCHMARKS
 //------------------------------------------------------------------------------
@@ -129,13 +167,40 @@ BENCHMARK(parse_medium_array);
 
 static void parse_large_array(benchmark::State &state) {
     std::string json = generate_random_array(1000);
+    const auto allocations_before = allocation_count;
     for (auto _ : state) {
         auto result = jayson::parse_direct(json);
         benchmark::DoNotOptimize(result);
     }
+    report_allocations(state, allocations_before);
 }
 BENCHMARK(parse_large_array);
 
+static void parse_large_array_document(benchmark::State &state) {
+    std::string json = generate_random_array(1000);
+    const auto allocations_before = allocation_count;
+    for (auto _ : state) {
+        auto result = jayson::parse_document(json);
+        benchmark::DoNotOptimize(result.root());
+    }
+    report_allocations(state, allocations_before);
+}
+BENCHMARK(parse_large_array_document);
+
+// Looks up every key of an object once; small objects are searched linearly, large ones through their index
+static void get_value_for_object(benchmark::State &state) {
+    std::string json = generate_random_object(static_cast<size_t>(state.range(0)));
+    auto result = jayson::parse_document(json);
+    const auto *object = result.root()->to_object();
+    const auto keys = object->get_keys();
+    for (auto _ : state) {
+        for (const auto &key : keys)
+            benchmark::DoNotOptimize(object->get_value_for(key));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+BENCHMARK(get_value_for_object)->Arg(5)->Arg(16)->Arg(50)->Arg(500);
+
 //------------------------------------------------------------------------------
 // NESTED STRUCTURE BENCHMARKS
 //------------------------------------------------------------------------------
@@ -307,13 +372,362 @@ static void parse_red_dress_json(benchmark::State &state) {
         return;
     }
 
+    const auto allocations_before = allocation_count;
     for (auto _ : state) {
         auto result = jayson::parse_direct(input);
         benchmark::DoNotOptimize(result);
     }
+    report_allocations(state, allocations_before);
 }
 BENCHMARK(parse_red_dress_json);
 
+// Only the destruction of the parsed tree is timed
+static void destroy_red_dress_json(benchmark::State &state) {
+    std::ifstream t("tests/red-dress.jayson");
+    if (!t.is_open()) {
+        state.SkipWithError("Could not open tests/red-dress.jayson");
+        return;
+    }
+    std::stringstream buffer;
+    buffer << t.rdbuf();
+    auto input = buffer.str();
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto result = jayson::parse_direct(input);
+        benchmark::DoNotOptimize(result);
+        state.ResumeTiming();
+        result.reset();
+    }
+}
+BENCHMARK(destroy_red_dress_json)->Iterations(20);
+
+// End-to-end: read the file the way the CLI used to, one character per stream call
+static void load_and_parse_red_dress_stream(benchmark::State &state) {
+    for (auto _ : state) {
+        std::ifstream file("tests/red-dress.jayson");
+        if (!file.is_open()) {
+            state.SkipWithError("Could not open tests/red-dress.jayson");
+            return;
+        }
+        auto input = std::string();
+        while (true) {
+            char c = file.get();
+            if (!file)
+                break;
+            input += c;
+        }
+        auto result = jayson::parse_direct(input);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(load_and_parse_red_dress_stream);
+
+// End-to-end: map the file and parse straight from the mapping
+static void load_and_parse_red_dress_mapped(benchmark::State &state) {
+    for (auto _ : state) {
+        auto file = jayson::mapped_file("tests/red-dress.jayson");
+        if (!file.is_open()) {
+            state.SkipWithError("Could not open tests/red-dress.jayson");
+            return;
+        }
+        auto result = jayson::parse_direct(file.view());
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(load_and_parse_red_dress_mapped);
+
+//------------------------------------------------------------------------------
+// TAPE BENCHMARKS
+//------------------------------------------------------------------------------
+
+static std::string read_red_dress() {
+    std::ifstream t("tests/red-dress.jayson");
+    std::stringstream buffer;
+    buffer << t.rdbuf();
+    return buffer.str();
+}
+
+// Visits every value and sums the integers, the way a consumer of the whole document would
+static jayson::integer_type traverse_tree(const jayson::jayson_element *element, std::size_t &values) {
+    values++;
+    jayson::integer_type sum = 0;
+    switch (element->get_type()) {
+    case jayson::jayson_types::OBJECT: {
+        const auto *object = element->to_object();
+        for (std::uint32_t i = 0; i < object->count; i++)
+            sum += traverse_tree(&object->members[i].value, values);
+        break;
+    }
+    case jayson::jayson_types::ARRAY: {
+        const auto *array = element->to_array();
+        for (std::size_t i = 0; i < array->count; i++)
+            sum += traverse_tree(&array->elements[i], values);
+        break;
+    }
+    case jayson::jayson_types::INTEGER:
+        sum += element->to_integer()->get_integer();
+        break;
+    default:
+        break;
+    }
+    return sum;
+}
+
+static jayson::integer_type traverse_tape(jayson::tape_cursor value, std::size_t &values) {
+    values++;
+    jayson::integer_type sum = 0;
+    switch (value.get_type()) {
+    case jayson::jayson_types::OBJECT:
+        for (auto member = value.first_child(); !member.at_end(); member = member.next().next())
+            sum += traverse_tape(member.next(), values);
+        break;
+    case jayson::jayson_types::ARRAY:
+        for (auto child = value.first_child(); !child.at_end(); child = child.next())
+            sum += traverse_tape(child, values);
+        break;
+    case jayson::jayson_types::INTEGER:
+        sum += *value.get_integer();
+        break;
+    default:
+        break;
+    }
+    return sum;
+}
+
+// Pretty-printing visits every node through get_type() and the to_...() accessors
+static void dump_red_dress_json(benchmark::State &state) {
+    auto input = read_red_dress();
+    auto result = jayson::parse_document(input);
+    if (!result.root()) {
+        state.SkipWithError("Could not parse tests/red-dress.jayson");
+        return;
+    }
+    for (auto _ : state) {
+        auto json = jayson::to_json(result.root());
+        benchmark::DoNotOptimize(json);
+    }
+}
+BENCHMARK(dump_red_dress_json);
+
+static void parse_large_array_tape(benchmark::State &state) {
+    std::string json = generate_random_array(1000);
+    const auto allocations_before = allocation_count;
+    for (auto _ : state) {
+        auto result = jayson::parse_to_tape(json);
+        benchmark::DoNotOptimize(result);
+    }
+    report_allocations(state, allocations_before);
+}
+BENCHMARK(parse_large_array_tape);
+
+static void parse_red_dress_tape(benchmark::State &state) {
+    auto input = read_red_dress();
+    if (input.empty()) {
+        state.SkipWithError("Could not read tests/red-dress.jayson");
+        return;
+    }
+    const auto allocations_before = allocation_count;
+    for (auto _ : state) {
+        auto result = jayson::parse_to_tape(input);
+        benchmark::DoNotOptimize(result);
+    }
+    report_allocations(state, allocations_before);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK(parse_red_dress_tape);
+
+static void traverse_red_dress_tree(benchmark::State &state) {
+    auto input = read_red_dress();
+    auto result = jayson::parse_document(input);
+    if (!result.root()) {
+        state.SkipWithError("Could not parse tests/red-dress.jayson");
+        return;
+    }
+    std::size_t values = 0;
+    for (auto _ : state) {
+        values = 0;
+        benchmark::DoNotOptimize(traverse_tree(result.root(), values));
+    }
+    state.counters["values"] = static_cast<double>(values);
+}
+BENCHMARK(traverse_red_dress_tree);
+
+static void traverse_red_dress_tape(benchmark::State &state) {
+    auto input = read_red_dress();
+    auto result = jayson::parse_to_tape(input);
+    if (!result) {
+        state.SkipWithError("Could not parse tests/red-dress.jayson");
+        return;
+    }
+    std::size_t values = 0;
+    for (auto _ : state) {
+        values = 0;
+        benchmark::DoNotOptimize(traverse_tape(result->root(), values));
+    }
+    state.counters["values"] = static_cast<double>(values);
+}
+BENCHMARK(traverse_red_dress_tape);
+
+// Looks up the last member of the root without visiting the members before it
+static void lookup_red_dress_tape(benchmark::State &state) {
+    auto input = read_red_dress();
+    auto result = jayson::parse_to_tape(input);
+    if (!result) {
+        state.SkipWithError("Could not parse tests/red-dress.jayson");
+        return;
+    }
+    auto root = result->root();
+    auto last_key = root.first_child();
+    while (!last_key.next().next().at_end())
+        last_key = last_key.next().next();
+    const auto key = *last_key.get_string();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(root.get_value_for(key));
+    }
+}
+BENCHMARK(lookup_red_dress_tape);
+
+//------------------------------------------------------------------------------
+// ON-DEMAND BENCHMARKS
+//------------------------------------------------------------------------------
+
+// Reads three fields: two behind the large network_interface member and one nested inside it
+static void extract_red_dress_fields_tree(benchmark::State &state) {
+    auto input = read_red_dress();
+    for (auto _ : state) {
+        auto result = jayson::parse_document(input);
+        const auto *root = result.root()->to_object();
+        auto name = root->get_value_for("name")->to_string()->get_string();
+        auto hash = root->get_value_for("commit_hash")->to_string()->get_string();
+        auto node_id = root->get_value_for("network_interface")->to_object()->get_value_for("network")->to_object()
+                           ->get_value_for("exports")->to_array()->get_value_at(0)->to_object()
+                           ->get_value_for("Node")->to_object()->get_value_for("node_id")->to_integer()->get_integer();
+        benchmark::DoNotOptimize(name);
+        benchmark::DoNotOptimize(hash);
+        benchmark::DoNotOptimize(node_id);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK(extract_red_dress_fields_tree);
+
+static void extract_red_dress_fields_lazy(benchmark::State &state) {
+    auto input = read_red_dress();
+    const auto allocations_before = allocation_count;
+    for (auto _ : state) {
+        jayson::lazy_document document(input);
+        auto name = document.find_field("name")->get_string();
+        auto hash = document.find_field("commit_hash")->get_string();
+        auto node_id = document.find_field("network_interface")->find_field("network")->find_field("exports")
+                           ->at(0)->find_field("Node")->find_field("node_id")->get_integer();
+        benchmark::DoNotOptimize(name);
+        benchmark::DoNotOptimize(hash);
+        benchmark::DoNotOptimize(node_id);
+    }
+    report_allocations(state, allocations_before);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK(extract_red_dress_fields_lazy);
+
+//------------------------------------------------------------------------------
+// EVENT BENCHMARKS
+//------------------------------------------------------------------------------
+
+// Counts the values and sums the integers, as cheap a consumer as there is
+struct counting_handler {
+    std::size_t values = 0;
+    jayson::integer_type sum = 0;
+
+    void on_object_begin() { values++; }
+    void on_key(jayson::string_type) {}
+    void on_object_end() {}
+    void on_array_begin() { values++; }
+    void on_array_end() {}
+    void on_string(jayson::string_type) { values++; }
+    void on_integer(jayson::integer_type value) { values++; sum += value; }
+    void on_float(jayson::float_type) { values++; }
+    void on_boolean(bool) { values++; }
+    void on_none() { values++; }
+};
+
+static void parse_2mb_events(benchmark::State &state, const std::string &base) {
+    auto input = make_test_document(base);
+    const auto allocations_before = allocation_count;
+    for (auto _ : state) {
+        counting_handler handler;
+        benchmark::DoNotOptimize(jayson::parse_events(input, handler));
+        benchmark::DoNotOptimize(handler.sum);
+    }
+    report_allocations(state, allocations_before);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+static void parse_2mb_direct(benchmark::State &state, const std::string &base) {
+    auto input = make_test_document(base);
+    const auto allocations_before = allocation_count;
+    for (auto _ : state) {
+        auto result = jayson::parse_direct(input);
+        benchmark::DoNotOptimize(result);
+    }
+    report_allocations(state, allocations_before);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+// The whole document at once against the same document arriving in chunks of state.range(0) bytes
+static void parse_red_dress_events(benchmark::State &state) {
+    const auto input = read_red_dress();
+    for (auto _ : state) {
+        counting_handler handler;
+        benchmark::DoNotOptimize(jayson::parse_events(input, handler));
+        benchmark::DoNotOptimize(handler.sum);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+static void parse_red_dress_feed(benchmark::State &state) {
+    const auto input = read_red_dress();
+    const auto chunk_size = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        counting_handler handler;
+        jayson::feed_parser parser(handler);
+        for (size_t offset = 0; offset < input.size(); offset += chunk_size)
+            parser.feed(std::string_view(input).substr(offset, chunk_size));
+        benchmark::DoNotOptimize(parser.finish());
+        benchmark::DoNotOptimize(handler.sum);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+BENCHMARK(parse_red_dress_events);
+BENCHMARK(parse_red_dress_feed)->Arg(64)->Arg(1500)->Arg(64 * 1024);
+
+BENCHMARK_CAPTURE(parse_2mb_events, realistic, generate_realistic_json());
+BENCHMARK_CAPTURE(parse_2mb_direct, realistic, generate_realistic_json());
+BENCHMARK_CAPTURE(parse_2mb_events, objects, generate_random_object(100));
+BENCHMARK_CAPTURE(parse_2mb_direct, objects, generate_random_object(100));
+BENCHMARK_CAPTURE(parse_2mb_events, integers, generate_random_array(100));
+BENCHMARK_CAPTURE(parse_2mb_direct, integers, generate_random_array(100));
+BENCHMARK_CAPTURE(parse_2mb_events, nested, generate_complex_json(5, 3));
+BENCHMARK_CAPTURE(parse_2mb_direct, nested, generate_complex_json(5, 3));
+
+//------------------------------------------------------------------------------
+// NDJSON BENCHMARKS
+//------------------------------------------------------------------------------
+
+// A million small records parsed on state.range(0) threads
+static void parse_ndjson_records(benchmark::State &state) {
+    static const auto input = generate_ndjson(1000000);
+    const auto threads = static_cast<unsigned>(state.range(0));
+    for (auto _ : state) {
+        auto batch = jayson::parse_many(input, threads);
+        benchmark::DoNotOptimize(batch.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 1000000));
+}
+
+BENCHMARK(parse_ndjson_records)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
 //------------------------------------------------------------------------------
 // FORMATTING VARIATION BENCHMARKS
 //------------------------------------------------------------------------------
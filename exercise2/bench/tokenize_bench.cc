@@ -84,6 +84,7 @@ static void tokenize_excessive_whitespace(benchmark::State &state) {
         auto tokenizer = jayson::tokenize(test_string);
         while (tokenizer.get_next_token().has_value()) {}
     }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * test_string.size()));
 }
 BENCHMARK(tokenize_excessive_whitespace);
 
@@ -223,6 +224,7 @@ static void tokenize_realistic_json(benchmark::State &state) {
         auto tokenizer = jayson::tokenize(test_string);
         while (tokenizer.get_next_token().has_value()) {}
     }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * test_string.size()));
 }
 BENCHMARK(tokenize_realistic_json);
 
@@ -2,11 +2,14 @@
 #define INCLUDED_JAYSON_HPP
 
 #include "jayson_fixed.hpp"
+#include "jayson_arena.hpp"
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <new>
 #include <optional>
 #include <vector>
-#include <unordered_map>
 
 namespace jayson {
 
@@ -100,100 +103,205 @@ struct tokenizer {
 
     [[nodiscard]] std::optional<token> get_next_token();
     [[nodiscard]] std::optional<token> peek_next_token() const;
+    // Advances past the next token without returning it; O(1) after a peek.
+    void skip_next_token();
 
 private:
 
+    // One bit per byte of a 64-byte block of the input.
+    struct block_masks {
+        std::uint64_t whitespace;
+        std::uint64_t structural;
+        std::uint64_t quote;
+    };
+
+    [[nodiscard]] std::optional<token> scan_next_token() const;
+    [[nodiscard]] std::optional<token> scan_and_skip_token();
+    [[nodiscard]] size_t token_end(const token &t) const;
+    [[nodiscard]] size_t next_token_start(size_t from) const;
+    [[nodiscard]] std::optional<token> peek_value_token(size_t current_pos) const;
+    void classify_block(size_t start) const;
+
     string_type input;
     size_t pos;
+    // Masks of the most recently classified block, starting at block_start.
+    mutable size_t block_start = SIZE_MAX;
+    mutable block_masks block{};
+    // The token last peeked at position peeked_from, and the position behind it.
+    mutable size_t peeked_from = SIZE_MAX;
+    mutable size_t peeked_end = 0;
+    mutable std::optional<token> peeked_token;
 
 };
 
-struct jayson_element_base {
+// The payloads of jayson_element. Everything lives in an arena and is never destroyed, so no payload owns
+// anything.
 
-    virtual ~jayson_element_base() = default;
-    [[nodiscard]] virtual jayson_types get_type() const = 0;
+struct jayson_member;
 
-};
+// Members in document order. Objects with more than linear_lookup_limit members are followed by a hash index of
+// index_size slots in the same arena block; smaller ones are searched linearly, which beats hashing the key.
+struct jayson_object {
 
-struct jayson_object : jayson_element_base {
+    static constexpr std::size_t linear_lookup_limit = 16;
 
-    std::unordered_map<string_type, std::unique_ptr<jayson_element>> map;
+    const jayson_member *members;
+    std::uint32_t count;
+    std::uint32_t index_size;
 
-    [[nodiscard]] jayson_types get_type() const override;
+    jayson_object(const jayson_member *members, std::uint32_t count, std::uint32_t index_size);
+    [[nodiscard]] jayson_types get_type() const;
     [[nodiscard]] integer_type size() const;
     [[nodiscard]] std::vector<string_type> get_keys() const;
     [[nodiscard]] std::vector<const jayson_element *> get_values() const;
     [[nodiscard]] const jayson_element *get_value_for(const string_type &key) const;
 };
 
-struct jayson_array : jayson_element_base {
+struct jayson_array {
 
-    std::vector<std::unique_ptr<jayson_element>> array;
+    const jayson_element *elements;
+    std::size_t count;
 
-    [[nodiscard]] jayson_types get_type() const override;
+    jayson_array(const jayson_element *elements, std::size_t count);
+    [[nodiscard]] jayson_types get_type() const;
     [[nodiscard]] integer_type size() const;
     [[nodiscard]] std::vector<const jayson_element *> get_elements() const;
     [[nodiscard]] const jayson_element *get_value_at(integer_type index) const;
 };
 
-struct jayson_string : jayson_element_base{
+struct jayson_string {
 
     string_type string;
 
     explicit jayson_string(const string_type& value);
-    [[nodiscard]] jayson_types get_type() const override;
+    [[nodiscard]] jayson_types get_type() const;
     [[nodiscard]] string_type get_string() const;
 };
 
-struct jayson_integer : jayson_element_base {
+struct jayson_integer {
 
     integer_type integer;
 
     explicit jayson_integer(const integer_type& value);
-    [[nodiscard]] jayson_types get_type() const override;
+    [[nodiscard]] jayson_types get_type() const;
     [[nodiscard]] integer_type get_integer() const;
 };
 
-struct jayson_float : jayson_element_base {
+struct jayson_float {
 
     float_type floating;
 
     explicit jayson_float(const float_type& value);
-    [[nodiscard]] jayson_types get_type() const override;
+    [[nodiscard]] jayson_types get_type() const;
     [[nodiscard]] float_type get_float() const;
 };
 
-struct jayson_boolean : jayson_element_base{
+struct jayson_boolean {
 
     bool boolean;
 
     explicit jayson_boolean(const bool& value);
-    [[nodiscard]] jayson_types get_type() const override;
+    [[nodiscard]] jayson_types get_type() const;
     [[nodiscard]] bool get_boolean() const;
 };
 
-struct jayson_none : jayson_element_base {
-    [[nodiscard]] jayson_types get_type() const override;
+struct jayson_none {
+    [[nodiscard]] jayson_types get_type() const;
 };
 
+// A type tag and the payload it selects, so type checks compare the tag and the to_...() accessors need no cast.
 struct jayson_element {
 
-    explicit jayson_element(std::unique_ptr<jayson_element_base> element);
-    [[nodiscard]] jayson_types get_type() const;
-    [[nodiscard]] const jayson_object *to_object() const;
-    [[nodiscard]] const jayson_array *to_array() const;
-    [[nodiscard]] const jayson_string *to_string() const;
-    [[nodiscard]] const jayson_integer *to_integer() const;
-    [[nodiscard]] const jayson_float *to_float() const;
-    [[nodiscard]] const jayson_boolean *to_boolean() const;
-    [[nodiscard]] const jayson_none *to_none() const;
+    explicit jayson_element(jayson_none none);
+    explicit jayson_element(const jayson_object &object);
+    explicit jayson_element(const jayson_array &array);
+    explicit jayson_element(const jayson_string &string);
+    explicit jayson_element(const jayson_integer &integer);
+    explicit jayson_element(const jayson_float &floating);
+    explicit jayson_element(const jayson_boolean &boolean);
+
+    // Elements created with new carry a header with the arena of the tree they are the root of, so deleting the
+    // root returned by parse() also releases the tree. Nodes in the arena carry nothing.
+    static void *operator new(std::size_t size);
+    static void operator delete(void *element);
+    static void operator delete(jayson_element *element, std::destroying_delete_t);
+
+    [[nodiscard]] jayson_types get_type() const {
+        return type;
+    }
+
+    [[nodiscard]] const jayson_object *to_object() const {
+        return type == jayson_types::OBJECT ? &object : nullptr;
+    }
+
+    [[nodiscard]] const jayson_array *to_array() const {
+        return type == jayson_types::ARRAY ? &array : nullptr;
+    }
+
+    [[nodiscard]] const jayson_string *to_string() const {
+        return type == jayson_types::STRING ? &string : nullptr;
+    }
+
+    [[nodiscard]] const jayson_integer *to_integer() const {
+        return type == jayson_types::INTEGER ? &integer : nullptr;
+    }
+
+    [[nodiscard]] const jayson_float *to_float() const {
+        return type == jayson_types::FLOAT ? &floating : nullptr;
+    }
+
+    [[nodiscard]] const jayson_boolean *to_boolean() const {
+        return type == jayson_types::BOOLEAN ? &boolean : nullptr;
+    }
+
+    [[nodiscard]] const jayson_none *to_none() const {
+        return type == jayson_types::NONE ? &none : nullptr;
+    }
 
 private:
 
-    std::unique_ptr<jayson_element_base> element;
+    jayson_types type;
+    union {
+        jayson_object object;
+        jayson_array array;
+        jayson_string string;
+        jayson_integer integer;
+        jayson_float floating;
+        jayson_boolean boolean;
+        jayson_none none;
+    };
+
+};
 
+struct jayson_member {
+    string_type key;
+    jayson_element value;
 };
 
+// A parsed document: every node is allocated in its arena and released at once with it.
+class document {
+
+public:
+
+    document() = default;
+    // A moved-from document is empty, its root() is nullptr.
+    document(document &&other) noexcept;
+    document &operator=(document &&other) noexcept;
+
+    // Nullptr if the input did not parse.
+    [[nodiscard]] const jayson_element *root() const;
+
+private:
+
+    friend document parse_document(std::string_view input);
+
+    arena nodes;
+    const jayson_element *root_element = nullptr;
+
+};
+
+[[nodiscard]] document parse_document(std::string_view input);
+
 } // namespace jayson
 
 #endif
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef INCLUDED_JAYSON_ARENA_HPP
+#define INCLUDED_JAYSON_ARENA_HPP
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace jayson {
+
+// Bump allocator for parsed documents. Objects are placement-constructed in chunks that are only
+// released together when the arena is destroyed; destructors of the objects are never run, so only
+// types whose destructors have no effects beyond freeing arena memory may be created in it.
+class arena {
+
+public:
+
+    arena() = default;
+    arena(const arena &) = delete;
+    arena &operator=(const arena &) = delete;
+    arena(arena &&other) noexcept;
+    arena &operator=(arena &&other) noexcept;
+    ~arena();
+
+    [[nodiscard]] void *allocate(std::size_t size, std::size_t alignment) {
+        auto address = (reinterpret_cast<std::size_t>(cursor) + alignment - 1) & ~(alignment - 1);
+        if (cursor == nullptr || address + size > reinterpret_cast<std::size_t>(end))
+            return allocate_in_new_chunk(size, alignment);
+        cursor = reinterpret_cast<char *>(address + size);
+        return reinterpret_cast<void *>(address);
+    }
+
+    template<typename T, typename... Args>
+    [[nodiscard]] T *create(Args &&... args) {
+        return ::new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Bytes taken from the system, including the unused tail of the current chunk.
+    [[nodiscard]] std::size_t reserved() const;
+
+private:
+
+    struct chunk {
+        chunk *previous;
+        std::size_t size;
+    };
+
+    void *allocate_in_new_chunk(std::size_t size, std::size_t alignment);
+
+    chunk *last = nullptr;
+    char *cursor = nullptr;
+    char *end = nullptr;
+    std::size_t next_chunk_size = 4 * 1024;
+
+};
+
+} // namespace jayson
+
+#endif
@@ -15,7 +15,12 @@ std::string to_json(const jayson_element *source, int indent = 0);
 namespace detail {
 
     inline auto to_json_string(string_type str) {
-        return "\"" + std::string {str} + "\"";
+        auto result = std::string {};
+        result.reserve(str.size() + 2);
+        result += '"';
+        result += str;
+        result += '"';
+        return result;
     }
 
     inline std::string make_indent(int indent, bool newline = true) {
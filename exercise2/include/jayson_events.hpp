@@ -0,0 +1,173 @@
+#ifndef INCLUDED_JAYSON_EVENTS_HPP
+#define INCLUDED_JAYSON_EVENTS_HPP
+
+#include "jayson.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace jayson {
+
+namespace detail {
+
+    enum class event_container : std::uint8_t { OBJECT, ARRAY };
+
+    // The grammar behind parse_events, fed one token at a time so that the caller decides where tokens come from.
+    // Accepts a sequence of top-level values.
+    template<typename Handler>
+    class event_machine {
+
+    public:
+
+        explicit event_machine(Handler &handler)
+            : handler(handler) {
+        }
+
+        // Reports the events of the token; false if it cannot continue a valid sequence of values.
+        bool consume(const token &t) {
+            const auto type = t.get_type();
+            switch (state) {
+                case expecting::FIRST_ELEMENT:
+                    if (type == token_type::ARRAY_END)
+                        return close_array();
+                    return consume_value(t);
+                case expecting::VALUE:
+                    return type == token_type::COMMENT || consume_value(t);
+                case expecting::FIRST_KEY:
+                    if (type == token_type::OBJECT_END)
+                        return close_object();
+                    [[fallthrough]];
+                case expecting::KEY:
+                    if (type == token_type::COMMENT)
+                        return true;
+                    if (type != token_type::STRING)
+                        return false;
+                    handler.on_key(t.get_string().value());
+                    state = expecting::COLON;
+                    return true;
+                case expecting::COLON:
+                    if (type == token_type::COMMENT)
+                        return true;
+                    state = expecting::VALUE;
+                    return type == token_type::COLON;
+                case expecting::SEPARATOR:
+                    if (type == token_type::COMMA) {
+                        state = open.back() == event_container::OBJECT ? expecting::KEY : expecting::VALUE;
+                        return true;
+                    }
+                    if (type == token_type::OBJECT_END)
+                        return open.back() == event_container::OBJECT && close_object();
+                    if (type == token_type::ARRAY_END)
+                        return open.back() == event_container::ARRAY && close_array();
+                    return type == token_type::COMMENT;
+            }
+            return false;
+        }
+
+        // Number of top-level values completed so far.
+        [[nodiscard]] std::size_t values() const {
+            return completed;
+        }
+
+        // True between top-level values, the only place where the input may end.
+        [[nodiscard]] bool between_values() const {
+            return state == expecting::VALUE && open.empty();
+        }
+
+    private:
+
+        enum class expecting : std::uint8_t { VALUE, FIRST_ELEMENT, FIRST_KEY, KEY, COLON, SEPARATOR };
+
+        bool consume_value(const token &t) {
+            switch (t.get_type()) {
+                case token_type::OBJECT_BEGIN:
+                    handler.on_object_begin();
+                    open.push_back(event_container::OBJECT);
+                    state = expecting::FIRST_KEY;
+                    return true;
+                case token_type::ARRAY_BEGIN:
+                    handler.on_array_begin();
+                    open.push_back(event_container::ARRAY);
+                    state = expecting::FIRST_ELEMENT;
+                    return true;
+                case token_type::STRING:
+                    handler.on_string(t.get_string().value());
+                    break;
+                case token_type::INTEGER:
+                    handler.on_integer(t.get_integer().value());
+                    break;
+                case token_type::FLOAT:
+                    handler.on_float(t.get_float().value());
+                    break;
+                case token_type::BOOLEAN:
+                    handler.on_boolean(t.get_boolean().value());
+                    break;
+                case token_type::NONE:
+                    handler.on_none();
+                    break;
+                case token_type::COMMENT:
+                    return true;
+                default:
+                    return false;
+            }
+            value_done();
+            return true;
+        }
+
+        bool close_object() {
+            handler.on_object_end();
+            open.pop_back();
+            value_done();
+            return true;
+        }
+
+        bool close_array() {
+            handler.on_array_end();
+            open.pop_back();
+            value_done();
+            return true;
+        }
+
+        void value_done() {
+            if (open.empty()) {
+                completed++;
+                state = expecting::VALUE;
+            } else {
+                state = expecting::SEPARATOR;
+            }
+        }
+
+        Handler &handler;
+        std::vector<event_container> open;
+        expecting state = expecting::VALUE;
+        std::size_t completed = 0;
+
+    };
+
+} // namespace detail
+
+// Parses input and reports it to handler as a stream of events instead of building a tree:
+//   on_object_begin(), on_key(string_type), on_object_end(),
+//   on_array_begin(), on_array_end(),
+//   on_string(string_type), on_integer(integer_type), on_float(float_type), on_boolean(bool), on_none().
+// Strings refer into the input. The handler is a template parameter, so its callbacks are inlined. Apart from
+// one byte per open object or array, memory use does not depend on the input. Returns whether the whole input
+// was a valid document; events reported before an error are not taken back.
+template<typename Handler>
+bool parse_events(string_type input, Handler &&handler) {
+    auto tokens = tokenize(input);
+    detail::event_machine<std::remove_reference_t<Handler>> machine(handler);
+    while (true) {
+        const auto t = tokens.get_next_token();
+        if (!t.has_value())
+            return machine.values() == 1 && machine.between_values();
+        if (!machine.consume(t.value()) || machine.values() > 1)
+            return false;
+    }
+}
+
+} // namespace jayson
+
+#endif
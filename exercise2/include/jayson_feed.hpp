@@ -0,0 +1,137 @@
+#ifndef INCLUDED_JAYSON_FEED_HPP
+#define INCLUDED_JAYSON_FEED_HPP
+
+#include "jayson.hpp"
+#include "jayson_events.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace jayson {
+
+namespace detail {
+
+    // True if rest, which starts with a token, could be the beginning of a token that continues past its end.
+    [[nodiscard]] bool token_reaches_end(string_type rest);
+
+    // The bytes of a chunk that continue a token begun in an earlier one.
+    struct token_rest {
+        // Up to and including the byte that ends the token.
+        std::size_t length;
+        // The token took the whole chunk and may go on in the next one.
+        bool open;
+    };
+
+    // Continues the token begun in pending with chunk. Only chunk is scanned, so a long token fed in small chunks is
+    // scanned once in total.
+    [[nodiscard]] token_rest pending_token_rest(string_type pending, string_type chunk);
+
+} // namespace detail
+
+// Resumable parse_events for input that arrives in chunks, such as from a socket or a pipe. Every chunk is parsed
+// as far as it holds whole tokens and the events are reported right away; only a token cut off at the end of a
+// chunk is copied, and it is completed by the next one. The input is a sequence of top-level values, so several
+// documents can follow one another on the same stream.
+// Strings passed to the handler refer into the chunk or the copy and are only valid during the callback.
+template<typename Handler>
+class feed_parser {
+
+public:
+
+    explicit feed_parser(Handler &handler)
+        : machine(handler) {
+    }
+
+    // Parses chunk; false once the input can no longer be valid, after which further chunks are ignored.
+    bool feed(string_type chunk) {
+        if (failed)
+            return false;
+        if (chunk.empty())
+            return true;
+        if (!pending.empty()) {
+            const auto rest = detail::pending_token_rest(pending, chunk);
+            pending.append(chunk.substr(0, rest.length));
+            chunk.remove_prefix(rest.length);
+            if (rest.open)
+                return true;
+            const std::string token_text = std::move(pending);
+            pending.clear();
+            if (!consume_tokens(token_text, true))
+                return false;
+        }
+        return consume_tokens(chunk, false);
+    }
+
+    // Ends the input; true if all of it was a sequence of complete values.
+    bool finish() {
+        if (!failed && !pending.empty()) {
+            const std::string token_text = std::move(pending);
+            pending.clear();
+            consume_tokens(token_text, true);
+        }
+        return !failed && machine.between_values();
+    }
+
+    // Number of top-level values completed so far.
+    [[nodiscard]] std::size_t values() const {
+        return machine.values();
+    }
+
+private:
+
+    // Consumes the tokens of text. Unless the end of text is known to end a token, a last token that may
+    // continue in the next chunk is kept in pending instead.
+    bool consume_tokens(string_type text, bool ends_token) {
+        auto tokens = tokenize(text);
+        std::size_t consumed = 0;
+        while (true) {
+            const auto t = tokens.get_next_token();
+            if (!t.has_value())
+                break;
+            const auto original = t.value().get_original();
+            const auto token_end = static_cast<std::size_t>(original.data() - text.data()) + original.size();
+            if (!ends_token && token_end == text.size() && may_continue(t.value()))
+                break;
+            if (!machine.consume(t.value())) {
+                failed = true;
+                return false;
+            }
+            consumed = token_end;
+        }
+        auto rest = text.substr(consumed);
+        while (!rest.empty() && (rest[0] == ' ' || rest[0] == '\n' || rest[0] == '\r' || rest[0] == '\t'))
+            rest.remove_prefix(1);
+        if (rest.empty())
+            return true;
+        if (ends_token || !detail::token_reaches_end(rest)) {
+            failed = true;
+            return false;
+        }
+        pending.assign(rest);
+        return true;
+    }
+
+    // Numbers and comments that end with the text may go on in the next chunk.
+    static bool may_continue(const token &t) {
+        switch (t.get_type()) {
+            case token_type::INTEGER:
+            case token_type::FLOAT:
+                return true;
+            case token_type::COMMENT:
+                return t.get_original().back() != '\n';
+            default:
+                return false;
+        }
+    }
+
+    detail::event_machine<Handler> machine;
+    std::string pending;
+    bool failed = false;
+
+};
+
+} // namespace jayson
+
+#endif
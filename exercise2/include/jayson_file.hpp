@@ -0,0 +1,123 @@
+#ifndef INCLUDED_JAYSON_FILE_HPP
+#define INCLUDED_JAYSON_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace jayson {
+
+// Read-only contents of a whole file for tokenize/parse_direct.
+// Regular files are mapped, everything else (pipes, /dev/stdin) is read into a buffer.
+// is_open() is false if the file could not be opened or a read failed before its end.
+struct mapped_file {
+
+    explicit mapped_file(const char *path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat file_stat {};
+        if (::fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode)) {
+            auto size = static_cast<size_t>(file_stat.st_size);
+            if (size > 0) {
+                void *memory = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+                if (memory != MAP_FAILED) {
+                    ::madvise(memory, size, MADV_SEQUENTIAL);
+                    mapping = static_cast<const char *>(memory);
+                    mapping_size = size;
+                    ::close(fd);
+                    opened = true;
+                    return;
+                }
+            }
+            buffer.resize(size);
+            opened = read_fully(fd, buffer.data(), size) == static_cast<ssize_t>(size);
+        } else {
+            // unknown size, read in large blocks until the end
+            constexpr size_t block = 1 << 16;
+            size_t length = 0;
+            while (true) {
+                buffer.resize(length + block);
+                auto read = read_fully(fd, buffer.data() + length, block);
+                if (read < 0) {
+                    // a failed read is not the end of the input, report it instead of parsing what arrived
+                    buffer.clear();
+                    ::close(fd);
+                    return;
+                }
+                length += static_cast<size_t>(read);
+                if (read < static_cast<ssize_t>(block))
+                    break;
+            }
+            buffer.resize(length);
+            opened = true;
+        }
+        ::close(fd);
+    }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    mapped_file(mapped_file &&other) noexcept
+        : mapping(std::exchange(other.mapping, nullptr)),
+          mapping_size(std::exchange(other.mapping_size, 0)),
+          buffer(std::move(other.buffer)),
+          opened(std::exchange(other.opened, false)) {
+    }
+
+    mapped_file &operator=(mapped_file &&other) noexcept {
+        std::swap(mapping, other.mapping);
+        std::swap(mapping_size, other.mapping_size);
+        std::swap(buffer, other.buffer);
+        std::swap(opened, other.opened);
+        return *this;
+    }
+
+    ~mapped_file() {
+        if (mapping)
+            ::munmap(const_cast<char *>(mapping), mapping_size);
+    }
+
+    [[nodiscard]] bool is_open() const {
+        return opened;
+    }
+
+    [[nodiscard]] std::string_view view() const {
+        return mapping ? std::string_view {mapping, mapping_size} : std::string_view {buffer};
+    }
+
+private:
+
+    // read until length bytes arrived or the file ended, returns the number of bytes read or -1 on a read error
+    static ssize_t read_fully(int fd, char *destination, size_t length) {
+        size_t done = 0;
+        while (done < length) {
+            auto result = ::read(fd, destination + done, length - done);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result < 0)
+                return -1;
+            if (result == 0)
+                break;
+            done += static_cast<size_t>(result);
+        }
+        return static_cast<ssize_t>(done);
+    }
+
+    const char *mapping = nullptr;
+    size_t mapping_size = 0;
+    std::string buffer;
+    bool opened = false;
+
+};
+
+} // namespace jayson
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef INCLUDED_JAYSON_LAZY_HPP
+#define INCLUDED_JAYSON_LAZY_HPP
+
+#include "jayson.hpp"
+
+#include <optional>
+#include <string_view>
+
+namespace jayson {
+
+// A value that has not been parsed yet, held as the input starting at the value. Every call scans only as far
+// as it needs to. Scalars passed on the way are tokenized like in parse(), but objects and arrays passed on the way
+// are skipped by tracking brackets, so their contents are neither converted nor validated beyond balanced brackets,
+// closed strings and well-formed comment starts.
+class lazy_value {
+
+public:
+
+    explicit lazy_value(string_type input)
+        : input(input) {
+    }
+
+    // Nullopt if no value starts here.
+    [[nodiscard]] std::optional<jayson_types> get_type() const;
+    // The first member with the key; unlike the element tree, where the last of duplicate keys wins.
+    [[nodiscard]] std::optional<lazy_value> find_field(const string_type &key) const;
+    [[nodiscard]] std::optional<lazy_value> at(integer_type index) const;
+
+    [[nodiscard]] std::optional<string_type> get_string() const;
+    [[nodiscard]] std::optional<integer_type> get_integer() const;
+    [[nodiscard]] std::optional<float_type> get_float() const;
+    [[nodiscard]] std::optional<bool> get_boolean() const;
+
+    // Parses this value, and only this value, into a document.
+    [[nodiscard]] document materialize() const;
+
+private:
+
+    string_type input;
+
+};
+
+// Entry point of the on-demand API. Nothing is scanned on construction, so a malformed document is only noticed
+// where a lookup runs into the malformed part.
+class lazy_document {
+
+public:
+
+    explicit lazy_document(string_type input)
+        : input(input) {
+    }
+
+    [[nodiscard]] lazy_value root() const {
+        return lazy_value(input);
+    }
+
+    [[nodiscard]] std::optional<lazy_value> find_field(const string_type &key) const {
+        return root().find_field(key);
+    }
+
+    [[nodiscard]] std::optional<lazy_value> at(integer_type index) const {
+        return root().at(index);
+    }
+
+private:
+
+    string_type input;
+
+};
+
+} // namespace jayson
+
+#endif
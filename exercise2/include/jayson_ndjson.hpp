@@ -0,0 +1,44 @@
+#ifndef INCLUDED_JAYSON_NDJSON_HPP
+#define INCLUDED_JAYSON_NDJSON_HPP
+
+#include "jayson.hpp"
+#include "jayson_arena.hpp"
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace jayson {
+
+// The documents of a newline-delimited input, in input order. All documents parsed by one thread share its arena,
+// so a batch of a million records is freed with a handful of chunks.
+class document_batch {
+
+public:
+
+    [[nodiscard]] std::size_t size() const {
+        return roots.size();
+    }
+
+    // Root of the index-th record; nullptr if that line did not parse.
+    [[nodiscard]] const jayson_element *operator[](std::size_t index) const {
+        return roots[index];
+    }
+
+private:
+
+    friend document_batch parse_many(std::string_view input, unsigned threads);
+
+    std::vector<arena> arenas;
+    std::vector<const jayson_element *> roots;
+
+};
+
+// Parses input as one document per line, skipping blank lines. The input is cut into one run of whole lines per
+// thread; threads == 0 takes one thread per hardware thread, and small inputs use fewer. Strings refer into the
+// input, which has to outlive the batch.
+[[nodiscard]] document_batch parse_many(std::string_view input, unsigned threads = 0);
+
+} // namespace jayson
+
+#endif
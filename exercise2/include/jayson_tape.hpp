@@ -0,0 +1,149 @@
+#ifndef INCLUDED_JAYSON_TAPE_HPP
+#define INCLUDED_JAYSON_TAPE_HPP
+
+#include "jayson.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace jayson {
+
+// Tag in the top byte of every tape word; the characters make dumped tapes readable.
+enum class tape_tag : std::uint8_t {
+    OBJECT_BEGIN = '{', // payload: count << 32 | index behind the matching OBJECT_END
+    OBJECT_END   = '}', // payload: index of the matching OBJECT_BEGIN
+    ARRAY_BEGIN  = '[', // payload: count << 32 | index behind the matching ARRAY_END
+    ARRAY_END    = ']', // payload: index of the matching ARRAY_BEGIN
+    STRING       = '"', // payload: offset into the input, the next word holds the length
+    INTEGER      = 'l', // the next word holds the integer
+    FLOAT        = 'd', // the next word holds the bits of the double
+    TRUE         = 't',
+    FALSE        = 'f',
+    NONE         = 'n',
+};
+
+class tape_cursor;
+
+// A whole document as one array of 64-bit words in document order. Objects alternate key strings
+// and values. Strings are not copied but refer into the input, which has to outlive the tape.
+class tape {
+
+public:
+
+    static constexpr int tag_shift = 56;
+    static constexpr std::uint64_t payload_mask = (std::uint64_t{1} << tag_shift) - 1;
+    // Container sizes are stored in 24 bits; larger containers are counted when asked.
+    static constexpr std::uint64_t max_stored_count = (std::uint64_t{1} << 24) - 1;
+
+    [[nodiscard]] tape_cursor root() const;
+
+    [[nodiscard]] const std::vector<std::uint64_t> &words() const {
+        return tape_words;
+    }
+
+    [[nodiscard]] string_type input() const {
+        return source;
+    }
+
+private:
+
+    friend std::optional<tape> parse_to_tape(std::string_view input);
+
+    string_type source;
+    std::vector<std::uint64_t> tape_words;
+
+};
+
+// Position of a value on a tape. Cheap to copy; next() steps over whole objects and arrays in O(1).
+class tape_cursor {
+
+public:
+
+    tape_cursor(const tape &document, std::size_t index)
+        : document(&document),
+          index(index) {
+    }
+
+    [[nodiscard]] jayson_types get_type() const {
+        switch (tag()) {
+            case tape_tag::OBJECT_BEGIN:
+            case tape_tag::OBJECT_END:
+                return jayson_types::OBJECT;
+            case tape_tag::ARRAY_BEGIN:
+            case tape_tag::ARRAY_END:
+                return jayson_types::ARRAY;
+            case tape_tag::STRING:
+                return jayson_types::STRING;
+            case tape_tag::INTEGER:
+                return jayson_types::INTEGER;
+            case tape_tag::FLOAT:
+                return jayson_types::FLOAT;
+            case tape_tag::TRUE:
+            case tape_tag::FALSE:
+                return jayson_types::BOOLEAN;
+            default:
+                return jayson_types::NONE;
+        }
+    }
+
+    // True at the end of the object or array whose children are being walked.
+    [[nodiscard]] bool at_end() const {
+        return tag() == tape_tag::OBJECT_END || tag() == tape_tag::ARRAY_END;
+    }
+
+    // The value behind this one, skipping its children.
+    [[nodiscard]] tape_cursor next() const {
+        switch (tag()) {
+            case tape_tag::OBJECT_BEGIN:
+            case tape_tag::ARRAY_BEGIN:
+                return {*document, static_cast<std::uint32_t>(payload())};
+            case tape_tag::STRING:
+            case tape_tag::INTEGER:
+            case tape_tag::FLOAT:
+                return {*document, index + 2};
+            default:
+                return {*document, index + 1};
+        }
+    }
+
+    // The first child of an object (its first key) or array; at_end() if it is empty.
+    [[nodiscard]] tape_cursor first_child() const {
+        return {*document, index + 1};
+    }
+
+    [[nodiscard]] std::optional<string_type> get_string() const;
+    [[nodiscard]] std::optional<integer_type> get_integer() const;
+    [[nodiscard]] std::optional<float_type> get_float() const;
+    [[nodiscard]] std::optional<bool> get_boolean() const;
+    // Number of members of an object or elements of an array.
+    [[nodiscard]] std::optional<integer_type> size() const;
+    [[nodiscard]] std::optional<tape_cursor> get_value_for(const string_type &key) const;
+    [[nodiscard]] std::optional<tape_cursor> get_value_at(integer_type index) const;
+
+    [[nodiscard]] std::size_t position() const {
+        return index;
+    }
+
+private:
+
+    [[nodiscard]] tape_tag tag() const {
+        return static_cast<tape_tag>(document->words()[index] >> tape::tag_shift);
+    }
+
+    [[nodiscard]] std::uint64_t payload() const {
+        return document->words()[index] & tape::payload_mask;
+    }
+
+    const tape *document;
+    std::size_t index;
+
+};
+
+// Parses input into a tape instead of a tree of elements; nullopt if the input did not parse.
+[[nodiscard]] std::optional<tape> parse_to_tape(std::string_view input);
+
+} // namespace jayson
+
+#endif
@@ -1,8 +1,25 @@
 #include "../include/jayson.hpp"
+#include "../include/jayson_tape.hpp"
+#include "../include/jayson_lazy.hpp"
+#include "../include/jayson_feed.hpp"
+#include "../include/jayson_ndjson.hpp"
 
-#include <ranges>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <thread>
 #include <variant>
 
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
 jayson::token_type jayson::token::get_type() const {
     return type;
 }
@@ -41,207 +58,467 @@ std::optional<jayson::string_type> jayson::token::get_comment() const {
     return std::nullopt;
 }
 
-std::optional<jayson::token> jayson::tokenizer::get_next_token() {
-    auto next_token = this->peek_next_token();
-    if (!next_token.has_value())
+//Token types of the structural characters, indexed by the character.
+constexpr auto structural_token_types = [] {
+    std::array<jayson::token_type, 128> types{};
+    types['{'] = jayson::token_type::OBJECT_BEGIN;
+    types['}'] = jayson::token_type::OBJECT_END;
+    types['['] = jayson::token_type::ARRAY_BEGIN;
+    types[']'] = jayson::token_type::ARRAY_END;
+    types[','] = jayson::token_type::COMMA;
+    types[':'] = jayson::token_type::COLON;
+    return types;
+}();
+
+//Returns the first '"' in [begin, end), or end. The string dialect has no escapes, so a backslash needs no stop.
+const char *find_quote(const char *begin, const char *end) {
+#if defined(__AVX2__)
+    const __m256i quote = _mm256_set1_epi8('"');
+    for (; end - begin >= 64; begin += 64) {
+        const __m256i low = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin)), quote);
+        const __m256i high = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin + 32)), quote);
+        if (!_mm256_testz_si256(_mm256_or_si256(low, high), _mm256_or_si256(low, high))) {
+            const std::uint64_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(low)) |
+                                       static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(high))) << 32;
+            return begin + std::countr_zero(mask);
+        }
+    }
+#endif
+    //SWAR: a byte of word ^ quotes is zero exactly where the input holds a quote.
+    constexpr std::uint64_t ones = 0x0101010101010101, highs = 0x8080808080808080, quotes = ones * '"';
+    for (; end - begin >= 8; begin += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, begin, sizeof(word));
+        word ^= quotes;
+        const std::uint64_t zero_bytes = (word - ones) & ~word & highs;
+        if (zero_bytes != 0) {
+            if constexpr (std::endian::native == std::endian::little)
+                return begin + std::countr_zero(zero_bytes) / 8;
+            break;
+        }
+    }
+    for (; begin != end; begin++) {
+        if (*begin == '"')
+            return begin;
+    }
+    return end;
+}
+
+//Loads 8 bytes as a little-endian word.
+std::uint64_t load_eight_bytes(const char *p) {
+    std::uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    if constexpr (std::endian::native == std::endian::big)
+        word = __builtin_bswap64(word);
+    return word;
+}
+
+//Whether all 8 bytes of a little-endian word are ASCII digits.
+bool is_eight_digits(std::uint64_t word) {
+    return ((word & 0xF0F0F0F0F0F0F0F0) | (((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+           0x3333333333333333;
+}
+
+//Converts 8 ASCII digits in a little-endian word, most significant first, in three multiply steps.
+std::uint64_t parse_eight_digits(std::uint64_t word) {
+    word -= 0x3030303030303030;
+    word = (word * 10) + (word >> 8);
+    return (((word & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+            (((word >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+}
+
+//Returns the end of the run of digits starting at p.
+const char *skip_digits(const char *p, const char *end) {
+    while (end - p >= 8 && is_eight_digits(load_eight_bytes(p)))
+        p += 8;
+    while (p != end && *p >= '0' && *p <= '9')
+        p++;
+    return p;
+}
+
+//Converts the digits [p, end) to an integer, or nullopt if the value does not fit.
+std::optional<jayson::integer_type> parse_integer(const char *p, const char *end, bool negative) {
+    while (end - p > 1 && *p == '0')
+        p++;
+    //Any 19 digits fit into 64 unsigned bits, so only the final range check can overflow.
+    if (end - p > 19)
         return std::nullopt;
-    this->pos = static_cast<size_t>(next_token.value().get_original().data() - this->input.data()) + next_token.value().
-                get_original().size();
-    return next_token;
+    std::uint64_t value = 0;
+    for (; end - p >= 8; p += 8)
+        value = value * 100000000 + parse_eight_digits(load_eight_bytes(p));
+    for (; p != end; p++)
+        value = value * 10 + static_cast<std::uint64_t>(*p - '0');
+    constexpr auto max = static_cast<std::uint64_t>(std::numeric_limits<jayson::integer_type>::max());
+    if (value > max + (negative ? 1 : 0))
+        return std::nullopt;
+    return negative ? static_cast<jayson::integer_type>(0 - value) : static_cast<jayson::integer_type>(value);
 }
 
-std::optional<jayson::token> jayson::tokenizer::peek_next_token() const {
-    size_t current_pos = this->pos;
-    size_t next_token_starting_pos;
-    string_type token_string;
-    string_type string_value;
+//Classifies the 64-byte block at start into whitespace, structural and quote bitmasks.
+//Both tables are indexed by the low nibble of a byte: whitespace bytes equal their own entry,
+//structural bytes equal their entry once 0x20 is or-ed in, which folds '[' onto '{' and ']' onto '}'.
+void jayson::tokenizer::classify_block(size_t start) const {
+    const char *data = this->input.data() + start;
+    //Pad the last block with whitespace so no bits are set past the end of the input.
+    char padded[64];
+    if (this->input.size() - start < 64) {
+        std::memset(padded, ' ', sizeof(padded));
+        std::memcpy(padded, data, this->input.size() - start);
+        data = padded;
+    }
 
-    while (current_pos < this->input.size()) {
-        switch (this->input[current_pos]) {
-            case ' ':
+#if defined(__AVX2__)
+    const __m256i whitespace_table = _mm256_setr_epi8(
+        ' ', 0, 0, 0, 0, 0, 0, 0, 0, '\t', '\n', 0, 0, '\r', 0, 0,
+        ' ', 0, 0, 0, 0, 0, 0, 0, 0, '\t', '\n', 0, 0, '\r', 0, 0);
+    const __m256i structural_table = _mm256_setr_epi8(
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0);
+    std::uint64_t whitespace = 0, structural = 0, quote = 0;
+    for (int half = 0; half < 2; half++) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 32 * half));
+        const __m256i folded = _mm256_or_si256(bytes, _mm256_set1_epi8(0x20));
+        const __m256i is_whitespace = _mm256_cmpeq_epi8(bytes, _mm256_shuffle_epi8(whitespace_table, bytes));
+        //Control characters such as 0x0C would fold onto ','; the signed compare also drops bytes >= 0x80.
+        const __m256i is_structural = _mm256_and_si256(
+            _mm256_cmpeq_epi8(folded, _mm256_shuffle_epi8(structural_table, bytes)),
+            _mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(0x20)));
+        const __m256i is_quote = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('"'));
+        whitespace |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(is_whitespace))) << (32 * half);
+        structural |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(is_structural))) << (32 * half);
+        quote |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(is_quote))) << (32 * half);
+    }
+#elif defined(__SSSE3__)
+    const __m128i whitespace_table = _mm_setr_epi8(' ', 0, 0, 0, 0, 0, 0, 0, 0, '\t', '\n', 0, 0, '\r', 0, 0);
+    const __m128i structural_table = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0);
+    std::uint64_t whitespace = 0, structural = 0, quote = 0;
+    for (int quarter = 0; quarter < 4; quarter++) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * quarter));
+        const __m128i folded = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+        const __m128i is_whitespace = _mm_cmpeq_epi8(bytes, _mm_shuffle_epi8(whitespace_table, bytes));
+        const __m128i is_structural = _mm_and_si128(
+            _mm_cmpeq_epi8(folded, _mm_shuffle_epi8(structural_table, bytes)),
+            _mm_cmpgt_epi8(bytes, _mm_set1_epi8(0x20)));
+        const __m128i is_quote = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('"'));
+        whitespace |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(is_whitespace))) << (16 * quarter);
+        structural |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(is_structural))) << (16 * quarter);
+        quote |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(is_quote))) << (16 * quarter);
+    }
+#else
+    std::uint64_t whitespace = 0, structural = 0, quote = 0;
+    for (int i = 0; i < 64; i++) {
+        const std::uint64_t bit = std::uint64_t{1} << i;
+        switch (data[i]) {
+            case ' ': case '\n': case '\r': case '\t':
+                whitespace |= bit;
                 break;
-            case '\n':
+            case '{': case '}': case '[': case ']': case ',': case ':':
+                structural |= bit;
                 break;
-            case '\r':
+            case '"':
+                quote |= bit;
                 break;
-            case '\t':
+            default:
                 break;
-            case '{':
-                token_string = string_type(this->input.data() + current_pos, 1);
-                return token(token_type::OBJECT_BEGIN, token_string);
-            case '}':
-                token_string = string_type(this->input.data() + current_pos, 1);
-                return token(token_type::OBJECT_END, token_string);
-            case '[':
-                token_string = string_type(this->input.data() + current_pos, 1);
-                return token(token_type::ARRAY_BEGIN, token_string);
-            case ']':
-                token_string = string_type(this->input.data() + current_pos, 1);
-                return token(token_type::ARRAY_END, token_string);
-            case ',':
-                token_string = string_type(this->input.data() + current_pos, 1);
-                return token(token_type::COMMA, token_string);
-            case ':':
-                token_string = string_type(this->input.data() + current_pos, 1);
-                return token(token_type::COLON, token_string);
-            case '"':
-                next_token_starting_pos = current_pos;
+        }
+    }
+#endif
+
+    this->block = block_masks{whitespace, structural, quote};
+    this->block_start = start;
+}
+
+//Returns the position of the first non-whitespace byte at or after from, or the input size.
+size_t jayson::tokenizer::next_token_start(size_t from) const {
+    while (from < this->input.size()) {
+        const size_t start = from & ~static_cast<size_t>(63);
+        if (start != this->block_start)
+            this->classify_block(start);
+        const std::uint64_t candidates = ~this->block.whitespace >> (from - start);
+        if (candidates != 0)
+            return from + static_cast<size_t>(std::countr_zero(candidates));
+        from = start + 64;
+    }
+    return this->input.size();
+}
+
+std::optional<jayson::token> jayson::tokenizer::get_next_token() {
+    //A get following a peek at the same position takes the peeked token.
+    if (this->peeked_from == this->pos) {
+        this->pos = this->peeked_end;
+        return this->peeked_token;
+    }
+    return this->scan_and_skip_token();
+}
+
+std::optional<jayson::token> jayson::tokenizer::peek_next_token() const {
+    if (this->peeked_from != this->pos) {
+        this->peeked_token = this->scan_next_token();
+        this->peeked_from = this->pos;
+        this->peeked_end = this->peeked_token.has_value() ? this->token_end(this->peeked_token.value()) : this->pos;
+    }
+    return this->peeked_token;
+}
+
+void jayson::tokenizer::skip_next_token() {
+    (void) this->peek_next_token();
+    this->pos = this->peeked_end;
+}
+
+//Kept apart from get_next_token so that its single named return builds the token in the caller's slot.
+std::optional<jayson::token> jayson::tokenizer::scan_and_skip_token() {
+    auto next_token = this->scan_next_token();
+    if (next_token.has_value())
+        this->pos = this->token_end(next_token.value());
+    return next_token;
+}
+
+size_t jayson::tokenizer::token_end(const token &t) const {
+    return static_cast<size_t>(t.get_original().data() - this->input.data()) + t.get_original().size();
+}
+
+std::optional<jayson::token> jayson::tokenizer::scan_next_token() const {
+    const size_t current_pos = this->next_token_start(this->pos);
+    if (current_pos == this->input.size())
+        return std::nullopt;
+    if (this->block.structural & (std::uint64_t{1} << (current_pos - this->block_start))) {
+        //Constructed in place: copying a temporary token into the optional stalls on store forwarding.
+        return std::optional<token>(std::in_place,
+                                    structural_token_types[static_cast<unsigned char>(this->input[current_pos])],
+                                    string_type(this->input.data() + current_pos, 1));
+    }
+    return this->peek_value_token(current_pos);
+}
+
+//Scans the string, comment, literal or number token starting at current_pos.
+std::optional<jayson::token> jayson::tokenizer::peek_value_token(size_t current_pos) const {
+    const std::uint64_t current_bit = std::uint64_t{1} << (current_pos - this->block_start);
+    size_t next_token_starting_pos;
+    string_type token_string;
+    string_type string_value;
+
+    switch (this->input[current_pos]) {
+        case '"': {
+            next_token_starting_pos = current_pos;
+            //The closing quote is usually in the same block.
+            const std::uint64_t later_quotes = this->block.quote & ~((current_bit << 1) - 1);
+            if (later_quotes != 0) {
+                current_pos = this->block_start + static_cast<size_t>(std::countr_zero(later_quotes));
+            } else {
+                const char *end = this->input.data() + this->input.size();
+                const char *quote = find_quote(this->input.data() + std::min(this->block_start + 64, this->input.size()), end);
+                if (quote == end)
+                    return std::nullopt;
+                current_pos = static_cast<size_t>(quote - this->input.data());
+            }
+            token_string = string_type(this->input.data() + next_token_starting_pos,
+                                            current_pos - next_token_starting_pos + 1);
+            string_value = string_type(this->input.data() + next_token_starting_pos + 1,
+                                            current_pos - next_token_starting_pos - 1);
+            return std::optional<token>(std::in_place, token_type::STRING, token_string, string_value);
+        }
+        case '/':
+            if (current_pos == (this->input.size() - 1))
+                return std::nullopt;
+            if (this->input[current_pos + 1] != '/')
+                return std::nullopt;
+            next_token_starting_pos = current_pos;
+            while (current_pos != (this->input.size() - 1) && this->input[current_pos] != '\n') {
                 current_pos++;
-                while (current_pos != this->input.size()) {
-                    if (this->input[current_pos] == '"') {
-                        token_string = string_type(this->input.data() + next_token_starting_pos,
-                                                        current_pos - next_token_starting_pos + 1);
-                        string_value = string_type(this->input.data() + next_token_starting_pos + 1,
-                                                        current_pos - next_token_starting_pos - 1);
-                        return token(token_type::STRING, token_string, string_value);
-                    }
-                    current_pos++;
-                }
+            }
+            token_string = string_type(this->input.data() + next_token_starting_pos,
+                                            current_pos - next_token_starting_pos + 1);
+            string_value = string_type(this->input.data() + next_token_starting_pos + 2,
+                                            current_pos - next_token_starting_pos - (
+                                                this->input[current_pos] == '\n' ? 2 : 1));
+            return std::optional<token>(std::in_place, token_type::COMMENT, token_string, string_value);
+        case 't':
+            if (current_pos + 4 > this->input.size())
                 return std::nullopt;
-            case '/':
-                if (current_pos == (this->input.size() - 1))
-                    return std::nullopt;
-                if (this->input[current_pos + 1] != '/')
-                    return std::nullopt;
-                next_token_starting_pos = current_pos;
-                while (current_pos != (this->input.size() - 1) && this->input[current_pos] != '\n') {
-                    current_pos++;
-                }
-                token_string = string_type(this->input.data() + next_token_starting_pos,
-                                                current_pos - next_token_starting_pos + 1);
-                string_value = string_type(this->input.data() + next_token_starting_pos + 2,
-                                                current_pos - next_token_starting_pos - (
-                                                    this->input[current_pos] == '\n' ? 2 : 1));
-                return token(token_type::COMMENT, token_string, string_value);
-            case 't':
-                if (current_pos + 4 > this->input.size())
-                    return std::nullopt;
-                if (this->input[current_pos + 1] == 'r' &&
-                    this->input[current_pos + 2] == 'u' &&
-                    this->input[current_pos + 3] == 'e') {
-                    token_string = string_type(this->input.data() + current_pos, 4);
-                    return token(token_type::BOOLEAN, token_string, true);
-                }
+            if (this->input[current_pos + 1] == 'r' &&
+                this->input[current_pos + 2] == 'u' &&
+                this->input[current_pos + 3] == 'e') {
+                token_string = string_type(this->input.data() + current_pos, 4);
+                return std::optional<token>(std::in_place, token_type::BOOLEAN, token_string, true);
+            }
+            return std::nullopt;
+        case 'f':
+            if (current_pos + 5 > this->input.size())
                 return std::nullopt;
-            case 'f':
-                if (current_pos + 5 > this->input.size())
-                    return std::nullopt;
-                if (this->input[current_pos + 1] == 'a' &&
-                    this->input[current_pos + 2] == 'l' &&
-                    this->input[current_pos + 3] == 's' &&
-                    this->input[current_pos + 4] == 'e') {
-                    token_string = string_type(this->input.data() + current_pos, 5);
-                    return token(token_type::BOOLEAN, token_string, false);
-                }
+            if (this->input[current_pos + 1] == 'a' &&
+                this->input[current_pos + 2] == 'l' &&
+                this->input[current_pos + 3] == 's' &&
+                this->input[current_pos + 4] == 'e') {
+                token_string = string_type(this->input.data() + current_pos, 5);
+                return std::optional<token>(std::in_place, token_type::BOOLEAN, token_string, false);
+            }
+            return std::nullopt;
+        case 'n':
+            if (current_pos + 4 > this->input.size())
                 return std::nullopt;
-            case 'n':
-                if (current_pos + 4 > this->input.size())
-                    return std::nullopt;
-                if (this->input[current_pos + 1] == 'u' &&
-                    this->input[current_pos + 2] == 'l' &&
-                    this->input[current_pos + 3] == 'l') {
-                    token_string = string_type(this->input.data() + current_pos, 4);
-                    return token(token_type::NONE, token_string);
-                }
+            if (this->input[current_pos + 1] == 'u' &&
+                this->input[current_pos + 2] == 'l' &&
+                this->input[current_pos + 3] == 'l') {
+                token_string = string_type(this->input.data() + current_pos, 4);
+                return std::optional<token>(std::in_place, token_type::NONE, token_string);
+            }
+            return std::nullopt;
+        default: {
+            //Parse numbers.
+            const char *const begin = this->input.data() + current_pos;
+            const char *const end = this->input.data() + this->input.size();
+            const char *p = begin;
+            //Parse optional negative sign.
+            const bool negative = *p == '-';
+            if (negative)
+                p++;
+            //Parse decimal part.
+            const char *const digits = p;
+            p = skip_digits(p, end);
+            if (p == digits)
                 return std::nullopt;
-            default:
-                //Parse numbers.
-                next_token_starting_pos = current_pos;
-                //Parse optional negative sign.
-                if (this->input[current_pos] == '-')
-                    current_pos++;
-                //Parse decimal part.
-                if (this->input[current_pos] < '0' || this->input[current_pos] > '9')
+            const char *const digits_end = p;
+            //Parse fraction part.
+            bool is_integer = true;
+            if (p != end && *p == '.') {
+                is_integer = false;
+                const char *const fraction = ++p;
+                p = skip_digits(p, end);
+                if (p == fraction)
                     return std::nullopt;
-                current_pos++;
-                while (this->input[current_pos] >= '0' && this->input[current_pos] <= '9') {
-                    current_pos++;
-                }
-                //Parse fraction part.
-                bool is_integer = true;
-                if (this->input[current_pos] == '.') {
-                    is_integer = false;
-                    current_pos++;
-                    if (this->input[current_pos] < '0' || this->input[current_pos] > '9')
-                        return std::nullopt;
-                    current_pos++;
-                    while (this->input[current_pos] >= '0' && this->input[current_pos] <= '9') {
-                        current_pos++;
-                    }
-                }
-                //Parse exponent.
-                if (this->input[current_pos] == 'e' || this->input[current_pos] == 'E') {
-                    is_integer = false;
-                    current_pos++;
-                    if (this->input[current_pos] == '-' || this->input[current_pos] == '+')
-                        current_pos++;
-                    if (this->input[current_pos] < '0' || this->input[current_pos] > '9')
-                        return std::nullopt;
-                    current_pos++;
-                    while (this->input[current_pos] >= '0' && this->input[current_pos] <= '9') {
-                        current_pos++;
-                    }
-                }
-                //Initialize token string.
-                token_string = string_type(this->input.data() + next_token_starting_pos, current_pos - next_token_starting_pos);
-                auto to_parse = std::string(token_string);
-                if (is_integer) {
-                    integer_type int_value;
-                    try {
-                        int_value = std::stoll(to_parse);
-                    } catch (const std::invalid_argument& e) {
-                        return std::nullopt;
-                    } catch (const std::out_of_range& e) {
-                        return std::nullopt;
-                    }
-                    return token(token_type::INTEGER, token_string, int_value);
-                }
-                float_type float_value;
-                try {
-                    float_value = std::stod(to_parse);
-                } catch (const std::invalid_argument& e) {
+            }
+            //Parse exponent.
+            if (p != end && (*p == 'e' || *p == 'E')) {
+                is_integer = false;
+                p++;
+                if (p != end && (*p == '-' || *p == '+'))
+                    p++;
+                const char *const exponent = p;
+                p = skip_digits(p, end);
+                if (p == exponent)
                     return std::nullopt;
-                } catch (const std::out_of_range& e) {
+            }
+            //Initialize token string.
+            token_string = string_type(begin, static_cast<size_t>(p - begin));
+            if (is_integer) {
+                const auto int_value = parse_integer(digits, digits_end, negative);
+                if (!int_value.has_value())
                     return std::nullopt;
-                }
-                return token(token_type::FLOAT, token_string, float_value);
+                return std::optional<token>(std::in_place, token_type::INTEGER, token_string, int_value.value());
+            }
+            //libstdc++ implements from_chars with the Eisel-Lemire fast path and an exact fallback,
+            //and reports out-of-range values through the error code.
+            float_type float_value;
+            if (std::from_chars(begin, p, float_value).ec != std::errc{})
+                return std::nullopt;
+            return std::optional<token>(std::in_place, token_type::FLOAT, token_string, float_value);
         }
-        current_pos++;
     }
-    return std::nullopt;
 }
 
 jayson::tokenizer jayson::tokenize(std::string_view input) {
     return tokenizer(input);
 }
 
+jayson::arena::arena(arena &&other) noexcept
+    : last(std::exchange(other.last, nullptr)),
+      cursor(std::exchange(other.cursor, nullptr)),
+      end(std::exchange(other.end, nullptr)),
+      next_chunk_size(other.next_chunk_size) {
+}
+
+jayson::arena &jayson::arena::operator=(arena &&other) noexcept {
+    std::swap(this->last, other.last);
+    std::swap(this->cursor, other.cursor);
+    std::swap(this->end, other.end);
+    std::swap(this->next_chunk_size, other.next_chunk_size);
+    return *this;
+}
+
+jayson::arena::~arena() {
+    while (this->last != nullptr) {
+        chunk *previous = this->last->previous;
+        ::operator delete(this->last, this->last->size);
+        this->last = previous;
+    }
+}
+
+std::size_t jayson::arena::reserved() const {
+    std::size_t total = 0;
+    for (const chunk *c = this->last; c != nullptr; c = c->previous)
+        total += c->size;
+    return total;
+}
+
+//Chunks double in size, so a document of n bytes takes O(log n) chunks.
+void *jayson::arena::allocate_in_new_chunk(std::size_t size, std::size_t alignment) {
+    const std::size_t chunk_size = std::max(this->next_chunk_size, sizeof(chunk) + size + alignment);
+    auto *c = static_cast<chunk *>(::operator new(chunk_size));
+    c->previous = this->last;
+    c->size = chunk_size;
+    this->last = c;
+    this->cursor = reinterpret_cast<char *>(c + 1);
+    this->end = reinterpret_cast<char *>(c) + chunk_size;
+    this->next_chunk_size *= 2;
+    return this->allocate(size, alignment);
+}
+
+jayson::jayson_object::jayson_object(const jayson_member *members, std::uint32_t count, std::uint32_t index_size)
+    : members(members),
+      count(count),
+      index_size(index_size) {
+}
+
 jayson::jayson_types jayson::jayson_object::get_type() const {
     return jayson_types::OBJECT;
 }
 
 jayson::integer_type jayson::jayson_object::size() const {
-    return static_cast<integer_type>(map.size());
+    return static_cast<integer_type>(this->count);
 }
 
 std::vector<jayson::string_type> jayson::jayson_object::get_keys() const {
     std::vector<string_type> result;
-    for (const auto key: map | std::views::keys) {
-        result.push_back(key);
-    }
+    result.reserve(this->count);
+    for (std::uint32_t i = 0; i < this->count; i++)
+        result.push_back(this->members[i].key);
     return result;
 }
 
 std::vector<const jayson::jayson_element *> jayson::jayson_object::get_values() const {
     std::vector<const jayson_element *> result;
-    for (auto&& val : this->map) {
-        result.push_back(val.second.get());
-    }
+    result.reserve(this->count);
+    for (std::uint32_t i = 0; i < this->count; i++)
+        result.push_back(&this->members[i].value);
     return result;
 }
 
+//Slot of key in a hash index of index_size (a power of two) slots holding member positions + 1: the slot of the
+//member with that key, or the empty slot ending its probe sequence.
+size_t object_index_slot(const std::uint32_t *index, std::uint32_t index_size, const jayson::jayson_member *members,
+                         jayson::string_type key) {
+    size_t slot = std::hash<jayson::string_type>{}(key) & (index_size - 1);
+    while (index[slot] != 0 && members[index[slot] - 1].key != key)
+        slot = (slot + 1) & (index_size - 1);
+    return slot;
+}
+
 const jayson::jayson_element *jayson::jayson_object::get_value_for(const string_type &key) const {
-    const auto it = map.find(key);
-    return it == map.end() ? nullptr : it->second.get();
+    if (this->index_size == 0) {
+        for (std::uint32_t i = 0; i < this->count; i++) {
+            if (this->members[i].key == key)
+                return &this->members[i].value;
+        }
+        return nullptr;
+    }
+    const auto *index = reinterpret_cast<const std::uint32_t *>(this->members + this->count);
+    const auto slot = object_index_slot(index, this->index_size, this->members, key);
+    return index[slot] == 0 ? nullptr : &this->members[index[slot] - 1].value;
+}
+
+jayson::jayson_array::jayson_array(const jayson_element *elements, std::size_t count)
+    : elements(elements),
+      count(count) {
 }
 
 jayson::jayson_types jayson::jayson_array::get_type() const {
@@ -249,21 +526,21 @@ jayson::jayson_types jayson::jayson_array::get_type() const {
 }
 
 jayson::integer_type jayson::jayson_array::size() const {
-    return static_cast<integer_type>(this->array.size());
+    return static_cast<integer_type>(this->count);
 }
 
 std::vector<const jayson::jayson_element *> jayson::jayson_array::get_elements() const {
     std::vector<const jayson::jayson_element *> result;
-    for (const auto& i : this->array) {
-        result.push_back(i.get());
-    }
+    result.reserve(this->count);
+    for (std::size_t i = 0; i < this->count; i++)
+        result.push_back(&this->elements[i]);
     return result;
 }
 
 const jayson::jayson_element *jayson::jayson_array::get_value_at(integer_type index) const {
     if (index < 0 || index >= this->size())
         return nullptr;
-    return this->array[index].get();
+    return &this->elements[index];
 }
 
 jayson::jayson_string::jayson_string(const string_type& value) : string(value) {
@@ -314,39 +591,25 @@ jayson::jayson_types jayson::jayson_none::get_type() const {
     return jayson_types::NONE;
 }
 
-jayson::jayson_element::jayson_element(std::unique_ptr<jayson_element_base> element): element(std::move(element)) {
-}
-
-jayson::jayson_types jayson::jayson_element::get_type() const {
-    return this->element->get_type();
+jayson::jayson_element::jayson_element(jayson_none none) : type(jayson_types::NONE), none(none) {
 }
 
-const jayson::jayson_object *jayson::jayson_element::to_object() const {
-    return dynamic_cast<const jayson_object *>(this->element.get());
+jayson::jayson_element::jayson_element(const jayson_object &object) : type(jayson_types::OBJECT), object(object) {
 }
 
-const jayson::jayson_array *jayson::jayson_element::to_array() const {
-    return dynamic_cast<const jayson_array *>(this->element.get());
+jayson::jayson_element::jayson_element(const jayson_array &array) : type(jayson_types::ARRAY), array(array) {
 }
 
-const jayson::jayson_string *jayson::jayson_element::to_string() const {
-    return dynamic_cast<const jayson_string *>(this->element.get());
+jayson::jayson_element::jayson_element(const jayson_string &string) : type(jayson_types::STRING), string(string) {
 }
 
-const jayson::jayson_integer *jayson::jayson_element::to_integer() const {
-    return dynamic_cast<const jayson_integer *>(this->element.get());
+jayson::jayson_element::jayson_element(const jayson_integer &integer) : type(jayson_types::INTEGER), integer(integer) {
 }
 
-const jayson::jayson_float *jayson::jayson_element::to_float() const {
-    return dynamic_cast<const jayson_float *>(this->element.get());
+jayson::jayson_element::jayson_element(const jayson_float &floating) : type(jayson_types::FLOAT), floating(floating) {
 }
 
-const jayson::jayson_boolean *jayson::jayson_element::to_boolean() const {
-    return dynamic_cast<const jayson_boolean *>(this->element.get());
-}
-
-const jayson::jayson_none *jayson::jayson_element::to_none() const {
-    return dynamic_cast<const jayson_none *>(this->element.get());
+jayson::jayson_element::jayson_element(const jayson_boolean &boolean) : type(jayson_types::BOOLEAN), boolean(boolean) {
 }
 
 std::optional<jayson::token> get_next_non_comment_token(jayson::tokenizer& tokens) {
@@ -366,107 +629,816 @@ std::optional<jayson::token> peek_next_non_comment_token(jayson::tokenizer& toke
             return t;
         if (t.value().get_type() != jayson::token_type::COMMENT)
             return t;
-        t = tokens.get_next_token();
+        tokens.skip_next_token();
     }
 }
 
-std::unique_ptr<jayson::jayson_element> parse_jayson_element(jayson::tokenizer& tokens);
+//State shared by the recursive parse functions.
+struct parser_state {
+    jayson::tokenizer &tokens;
+    jayson::arena &nodes;
+    //Elements of the arrays being parsed, innermost array last. Each array moves its run into the arena once
+    //complete, so arrays take exactly the space they need.
+    std::vector<jayson::jayson_element> elements;
+    //The same for the members of objects, plus the hash index of the latest large object.
+    std::vector<jayson::jayson_member> members;
+    std::vector<std::uint32_t> index;
+};
+
+std::optional<jayson::jayson_element> parse_jayson_value(parser_state &state);
+
+//A later member with the key of an earlier one hands its value to the earlier one and is marked by a null key.
+void merge_duplicate_member(jayson::jayson_member &earlier, jayson::jayson_member &later) {
+    earlier.value = std::move(later.value);
+    later.key = jayson::string_type();
+}
 
-std::unique_ptr<jayson::jayson_element> parse_jayson_object(jayson::tokenizer& tokens) {
-    auto object = std::make_unique<jayson::jayson_object>();
+//Fills index with members[0, count); returns whether duplicate keys were merged.
+bool build_object_index(std::vector<std::uint32_t> &index, jayson::jayson_member *members, size_t count) {
+    bool duplicates = false;
+    for (size_t i = 0; i < count; i++) {
+        const auto slot = object_index_slot(index.data(), static_cast<std::uint32_t>(index.size()), members, members[i].key);
+        if (index[slot] == 0) {
+            index[slot] = static_cast<std::uint32_t>(i + 1);
+        } else {
+            merge_duplicate_member(members[index[slot] - 1], members[i]);
+            duplicates = true;
+        }
+    }
+    return duplicates;
+}
+
+//Moves the members collected since first_member into the arena, followed by the hash index of a large object. Like
+//the map this replaces, the last of duplicate keys wins.
+std::optional<jayson::jayson_element> finish_jayson_object(parser_state &state, size_t first_member) {
+    auto &members = state.members;
+    auto *run = members.data() + first_member;
+    size_t count = members.size() - first_member;
+    bool duplicates = false;
+    std::uint32_t index_size = 0;
+    if (count <= jayson::jayson_object::linear_lookup_limit) {
+        for (size_t i = 1; i < count; i++) {
+            for (size_t j = 0; j < i; j++) {
+                if (run[j].key.data() != nullptr && run[j].key == run[i].key) {
+                    merge_duplicate_member(run[j], run[i]);
+                    duplicates = true;
+                    break;
+                }
+            }
+        }
+    } else {
+        if (count > std::numeric_limits<std::uint32_t>::max() / 2)
+            return std::nullopt;
+        index_size = std::bit_ceil(static_cast<std::uint32_t>(2 * count));
+        state.index.assign(index_size, 0);
+        duplicates = build_object_index(state.index, run, count);
+    }
+    if (duplicates) {
+        members.erase(std::remove_if(members.begin() + static_cast<std::ptrdiff_t>(first_member), members.end(),
+                                     [](const jayson::jayson_member &member) { return member.key.data() == nullptr; }),
+                      members.end());
+        run = members.data() + first_member;
+        count = members.size() - first_member;
+        if (index_size != 0) {
+            state.index.assign(index_size, 0);
+            build_object_index(state.index, run, count);
+        }
+    }
+    const size_t members_size = count * sizeof(jayson::jayson_member);
+    auto *storage = static_cast<char *>(
+        state.nodes.allocate(members_size + index_size * sizeof(std::uint32_t), alignof(jayson::jayson_member)));
+    auto *object_members = reinterpret_cast<jayson::jayson_member *>(storage);
+    std::uninitialized_move(run, run + count, object_members);
+    if (index_size != 0)
+        std::memcpy(storage + members_size, state.index.data(), index_size * sizeof(std::uint32_t));
+    members.erase(members.begin() + static_cast<std::ptrdiff_t>(first_member), members.end());
+    return std::optional<jayson::jayson_element>(
+        std::in_place, jayson::jayson_object(object_members, static_cast<std::uint32_t>(count), index_size));
+}
+
+std::optional<jayson::jayson_element> parse_jayson_object(parser_state &state) {
+    auto &tokens = state.tokens;
+    const size_t first_member = state.members.size();
     auto t = get_next_non_comment_token(tokens);
     if (!t.has_value())
-        return nullptr;
+        return std::nullopt;
     if (t.value().get_type() == jayson::token_type::OBJECT_END)
-        return std::make_unique<jayson::jayson_element>(std::move(object));
+        return finish_jayson_object(state, first_member);
     while (true) {
         if (t.value().get_type() != jayson::token_type::STRING)
-            return nullptr;
+            return std::nullopt;
         auto key = t.value().get_string().value();
         t = get_next_non_comment_token(tokens);
         if (!t.has_value())
-            return nullptr;
+            return std::nullopt;
         if (t.value().get_type() != jayson::token_type::COLON)
-            return nullptr;
-        auto key_pair = parse_jayson_element(tokens);
-        if (key_pair == nullptr)
-            return nullptr;
-        object->map[key] = std::move(key_pair);
+            return std::nullopt;
+        auto value = parse_jayson_value(state);
+        if (!value.has_value())
+            return std::nullopt;
+        state.members.push_back(jayson::jayson_member{key, std::move(value.value())});
         t = get_next_non_comment_token(tokens);
         if (!t.has_value())
-            return nullptr;
+            return std::nullopt;
         if (t.value().get_type() == jayson::token_type::OBJECT_END)
-            return std::make_unique<jayson::jayson_element>(std::move(object));
+            return finish_jayson_object(state, first_member);
         if (t.value().get_type() == jayson::token_type::COMMA) {
             t = get_next_non_comment_token(tokens);
             if (!t.has_value())
-                return nullptr;
+                return std::nullopt;
         } else {
-            return nullptr;
+            return std::nullopt;
         }
     }
 }
 
-std::unique_ptr<jayson::jayson_element> parse_jayson_array(jayson::tokenizer &tokens) {
-    auto array = std::make_unique<jayson::jayson_array>();
-    auto t = peek_next_non_comment_token(tokens);
-    if (!t.has_value())
-        return nullptr;
-    if (t.value().get_type() == jayson::token_type::ARRAY_END) {
-        t = get_next_non_comment_token(tokens);
-        return std::make_unique<jayson::jayson_element>(std::move(array));
+//Moves the elements collected since first_element into the arena.
+std::optional<jayson::jayson_element> finish_jayson_array(parser_state &state, size_t first_element) {
+    const size_t count = state.elements.size() - first_element;
+    auto *storage = static_cast<jayson::jayson_element *>(
+        state.nodes.allocate(count * sizeof(jayson::jayson_element), alignof(jayson::jayson_element)));
+    const auto first = state.elements.begin() + static_cast<std::ptrdiff_t>(first_element);
+    std::uninitialized_move(first, state.elements.end(), storage);
+    state.elements.erase(first, state.elements.end());
+    return std::optional<jayson::jayson_element>(std::in_place, jayson::jayson_array(storage, count));
+}
+
+std::optional<jayson::jayson_element> parse_jayson_array(parser_state &state) {
+    auto &tokens = state.tokens;
+    const size_t first_element = state.elements.size();
+    const auto first = peek_next_non_comment_token(tokens);
+    if (!first.has_value())
+        return std::nullopt;
+    if (first.value().get_type() == jayson::token_type::ARRAY_END) {
+        tokens.skip_next_token();
+        return finish_jayson_array(state, first_element);
     }
     while (true) {
-        auto array_element = parse_jayson_element(tokens);
-        if (array_element == nullptr)
-            return nullptr;
-        array->array.push_back(std::move(array_element));
-        t = peek_next_non_comment_token(tokens);
+        auto array_element = parse_jayson_value(state);
+        if (!array_element.has_value())
+            return std::nullopt;
+        state.elements.push_back(std::move(array_element.value()));
+        const auto t = peek_next_non_comment_token(tokens);
         if (!t.has_value())
-            return nullptr;
+            return std::nullopt;
         if (t.value().get_type() == jayson::token_type::ARRAY_END) {
-            t = get_next_non_comment_token(tokens);
-            return std::make_unique<jayson::jayson_element>(std::move(array));
+            tokens.skip_next_token();
+            return finish_jayson_array(state, first_element);
         }
         if (t.value().get_type() == jayson::token_type::COMMA) {
-            t = get_next_non_comment_token(tokens);
+            tokens.skip_next_token();
         } else {
-            return nullptr;
+            return std::nullopt;
         }
     }
 }
 
-std::unique_ptr<jayson::jayson_element> parse_jayson_element(jayson::tokenizer& tokens) {
-    auto t = get_next_non_comment_token(tokens);
+std::optional<jayson::jayson_element> parse_jayson_value(parser_state &state) {
+    auto t = get_next_non_comment_token(state.tokens);
     if (!t.has_value())
-        return nullptr;
+        return std::nullopt;
     switch (t.value().get_type()) {
         case jayson::token_type::OBJECT_BEGIN:
-            return parse_jayson_object(tokens);
+            return parse_jayson_object(state);
         case jayson::token_type::ARRAY_BEGIN:
-            return parse_jayson_array(tokens);
+            return parse_jayson_array(state);
         case jayson::token_type::NONE:
-            return std::make_unique<jayson::jayson_element>(std::make_unique<jayson::jayson_none>());
+            return std::optional<jayson::jayson_element>(std::in_place, jayson::jayson_none());
         case jayson::token_type::STRING:
-            return std::make_unique<jayson::jayson_element>(std::make_unique<jayson::jayson_string>(t.value().get_string().value()));
+            return std::optional<jayson::jayson_element>(std::in_place, jayson::jayson_string(t.value().get_string().value()));
         case jayson::token_type::INTEGER:
-            return std::make_unique<jayson::jayson_element>(std::make_unique<jayson::jayson_integer>(t.value().get_integer().value()));
+            return std::optional<jayson::jayson_element>(std::in_place, jayson::jayson_integer(t.value().get_integer().value()));
         case jayson::token_type::FLOAT:
-            return std::make_unique<jayson::jayson_element>(std::make_unique<jayson::jayson_float>(t.value().get_float().value()));
+            return std::optional<jayson::jayson_element>(std::in_place, jayson::jayson_float(t.value().get_float().value()));
         case jayson::token_type::BOOLEAN:
-            return std::make_unique<jayson::jayson_element>(std::make_unique<jayson::jayson_boolean>(t.value().get_boolean().value()));
+            return std::optional<jayson::jayson_element>(std::in_place, jayson::jayson_boolean(t.value().get_boolean().value()));
         default:
-            return nullptr;
+            return std::nullopt;
     }
 }
 
+//Precedes every jayson_element created with new; tree is the arena owned by a root returned by parse().
+struct heap_element_header {
+    alignas(std::max_align_t) jayson::arena *tree;
+};
+
+heap_element_header *header_of(void *element) {
+    return static_cast<heap_element_header *>(element) - 1;
+}
+
+void *jayson::jayson_element::operator new(std::size_t size) {
+    auto *header = ::new(::operator new(sizeof(heap_element_header) + size)) heap_element_header{nullptr};
+    return header + 1;
+}
+
+void jayson::jayson_element::operator delete(void *element) {
+    ::operator delete(header_of(element));
+}
+
+void jayson::jayson_element::operator delete(jayson_element *element, std::destroying_delete_t) {
+    auto *header = header_of(element);
+    element->~jayson_element();
+    delete header->tree;
+    ::operator delete(header);
+}
+
 std::unique_ptr<jayson::jayson_element> jayson::parse(tokenizer tokens) {
-    auto result = parse_jayson_element(tokens);
-    if (peek_next_non_comment_token(tokens).has_value())
+    auto nodes = std::make_unique<arena>();
+    parser_state state{tokens, *nodes, {}, {}, {}};
+    auto result = parse_jayson_value(state);
+    if (!result.has_value() || peek_next_non_comment_token(tokens).has_value())
         return nullptr;
-    return result;
+    auto root = std::make_unique<jayson_element>(std::move(result.value()));
+    header_of(root.get())->tree = nodes.release();
+    return root;
 }
 
 std::unique_ptr<jayson::jayson_element> jayson::parse_direct(std::string_view input) {
     return parse(tokenize(input));
 }
+
+jayson::document jayson::parse_document(std::string_view input) {
+    document result;
+    auto tokens = tokenize(input);
+    parser_state state{tokens, result.nodes, {}, {}, {}};
+    auto value = parse_jayson_value(state);
+    if (value.has_value() && !peek_next_non_comment_token(tokens).has_value())
+        result.root_element = result.nodes.create<jayson_element>(std::move(value.value()));
+    return result;
+}
+
+jayson::document::document(document &&other) noexcept
+    : nodes(std::move(other.nodes)),
+      root_element(std::exchange(other.root_element, nullptr)) {
+}
+
+jayson::document &jayson::document::operator=(document &&other) noexcept {
+    this->nodes = std::move(other.nodes);
+    this->root_element = std::exchange(other.root_element, nullptr);
+    return *this;
+}
+
+const jayson::jayson_element *jayson::document::root() const {
+    return this->root_element;
+}
+
+//State of parse_to_tape, the counterpart of parser_state.
+struct tape_writer {
+    jayson::tokenizer &tokens;
+    jayson::string_type input;
+    std::vector<std::uint64_t> &words;
+};
+
+std::uint64_t tape_word(jayson::tape_tag tag, std::uint64_t payload) {
+    return static_cast<std::uint64_t>(tag) << jayson::tape::tag_shift | payload;
+}
+
+void write_tape_string(tape_writer &writer, jayson::string_type string) {
+    writer.words.push_back(tape_word(jayson::tape_tag::STRING, static_cast<std::uint64_t>(string.data() - writer.input.data())));
+    writer.words.push_back(string.size());
+}
+
+bool write_tape_value(tape_writer &writer);
+
+//Writes an object or array whose opening token has been consumed. The begin word is patched once the end is known.
+bool write_tape_container(tape_writer &writer, bool object) {
+    auto &tokens = writer.tokens;
+    auto &words = writer.words;
+    const auto end_type = object ? jayson::token_type::OBJECT_END : jayson::token_type::ARRAY_END;
+    const size_t begin = words.size();
+    words.push_back(0);
+    std::uint64_t count = 0;
+    const auto first = peek_next_non_comment_token(tokens);
+    if (!first.has_value())
+        return false;
+    if (first.value().get_type() == end_type) {
+        tokens.skip_next_token();
+    } else {
+        while (true) {
+            if (object) {
+                auto key = get_next_non_comment_token(tokens);
+                if (!key.has_value() || key.value().get_type() != jayson::token_type::STRING)
+                    return false;
+                write_tape_string(writer, key.value().get_string().value());
+                auto colon = get_next_non_comment_token(tokens);
+                if (!colon.has_value() || colon.value().get_type() != jayson::token_type::COLON)
+                    return false;
+            }
+            if (!write_tape_value(writer))
+                return false;
+            count++;
+            auto t = get_next_non_comment_token(tokens);
+            if (!t.has_value())
+                return false;
+            if (t.value().get_type() == end_type)
+                break;
+            if (t.value().get_type() != jayson::token_type::COMMA)
+                return false;
+        }
+    }
+    //Indices are stored in 32 bits of the payload.
+    if (words.size() >= std::numeric_limits<std::uint32_t>::max())
+        return false;
+    words.push_back(tape_word(object ? jayson::tape_tag::OBJECT_END : jayson::tape_tag::ARRAY_END, begin));
+    words[begin] = tape_word(object ? jayson::tape_tag::OBJECT_BEGIN : jayson::tape_tag::ARRAY_BEGIN,
+                             std::min(count, jayson::tape::max_stored_count) << 32 | words.size());
+    return true;
+}
+
+bool write_tape_value(tape_writer &writer) {
+    auto t = get_next_non_comment_token(writer.tokens);
+    if (!t.has_value())
+        return false;
+    switch (t.value().get_type()) {
+        case jayson::token_type::OBJECT_BEGIN:
+            return write_tape_container(writer, true);
+        case jayson::token_type::ARRAY_BEGIN:
+            return write_tape_container(writer, false);
+        case jayson::token_type::NONE:
+            writer.words.push_back(tape_word(jayson::tape_tag::NONE, 0));
+            return true;
+        case jayson::token_type::STRING:
+            write_tape_string(writer, t.value().get_string().value());
+            return true;
+        case jayson::token_type::INTEGER:
+            writer.words.push_back(tape_word(jayson::tape_tag::INTEGER, 0));
+            writer.words.push_back(std::bit_cast<std::uint64_t>(t.value().get_integer().value()));
+            return true;
+        case jayson::token_type::FLOAT:
+            writer.words.push_back(tape_word(jayson::tape_tag::FLOAT, 0));
+            writer.words.push_back(std::bit_cast<std::uint64_t>(t.value().get_float().value()));
+            return true;
+        case jayson::token_type::BOOLEAN:
+            writer.words.push_back(tape_word(t.value().get_boolean().value() ? jayson::tape_tag::TRUE : jayson::tape_tag::FALSE, 0));
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::optional<jayson::tape> jayson::parse_to_tape(std::string_view input) {
+    std::optional<tape> result(std::in_place);
+    result->source = input;
+    //Typical documents need about one word per four bytes of input.
+    result->tape_words.reserve(input.size() / 4);
+    auto tokens = tokenize(input);
+    tape_writer writer{tokens, input, result->tape_words};
+    if (!write_tape_value(writer) || peek_next_non_comment_token(tokens).has_value())
+        return std::nullopt;
+    return result;
+}
+
+jayson::tape_cursor jayson::tape::root() const {
+    return {*this, 0};
+}
+
+std::optional<jayson::string_type> jayson::tape_cursor::get_string() const {
+    if (tag() == tape_tag::STRING)
+        return this->document->input().substr(payload(), this->document->words()[this->index + 1]);
+    return std::nullopt;
+}
+
+std::optional<jayson::integer_type> jayson::tape_cursor::get_integer() const {
+    if (tag() == tape_tag::INTEGER)
+        return std::bit_cast<integer_type>(this->document->words()[this->index + 1]);
+    return std::nullopt;
+}
+
+std::optional<jayson::float_type> jayson::tape_cursor::get_float() const {
+    if (tag() == tape_tag::FLOAT)
+        return std::bit_cast<float_type>(this->document->words()[this->index + 1]);
+    return std::nullopt;
+}
+
+std::optional<bool> jayson::tape_cursor::get_boolean() const {
+    if (tag() == tape_tag::TRUE || tag() == tape_tag::FALSE)
+        return tag() == tape_tag::TRUE;
+    return std::nullopt;
+}
+
+std::optional<jayson::integer_type> jayson::tape_cursor::size() const {
+    if (tag() != tape_tag::OBJECT_BEGIN && tag() != tape_tag::ARRAY_BEGIN)
+        return std::nullopt;
+    const auto count = payload() >> 32;
+    if (count < tape::max_stored_count)
+        return static_cast<integer_type>(count);
+    integer_type counted = 0;
+    for (auto child = first_child(); !child.at_end(); child = child.next()) {
+        if (tag() == tape_tag::OBJECT_BEGIN)
+            child = child.next();
+        counted++;
+    }
+    return counted;
+}
+
+//Keys are kept as written; like the element tree, the last of duplicate keys wins.
+std::optional<jayson::tape_cursor> jayson::tape_cursor::get_value_for(const string_type &key) const {
+    if (tag() != tape_tag::OBJECT_BEGIN)
+        return std::nullopt;
+    std::optional<tape_cursor> found;
+    for (auto member = first_child(); !member.at_end(); member = member.next().next()) {
+        if (member.get_string() == key)
+            found = member.next();
+    }
+    return found;
+}
+
+std::optional<jayson::tape_cursor> jayson::tape_cursor::get_value_at(integer_type index) const {
+    if (tag() != tape_tag::ARRAY_BEGIN || index < 0)
+        return std::nullopt;
+    auto element = first_child();
+    for (; !element.at_end() && index > 0; index--)
+        element = element.next();
+    if (element.at_end())
+        return std::nullopt;
+    return element;
+}
+
+//One bit per byte of a 64-byte block for the characters skip_container looks at.
+struct bracket_masks {
+    std::uint64_t open;
+    std::uint64_t close;
+    std::uint64_t quote;
+    std::uint64_t slash;
+};
+
+bracket_masks classify_brackets(const char *data) {
+#if defined(__AVX2__)
+    bracket_masks masks{};
+    for (int half = 0; half < 2; half++) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 32 * half));
+        //'[' and ']' fold onto '{' and '}'.
+        const __m256i folded = _mm256_or_si256(bytes, _mm256_set1_epi8(0x20));
+        const auto bits = [half](__m256i is) {
+            return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(is))) << (32 * half);
+        };
+        masks.open |= bits(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')));
+        masks.close |= bits(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}')));
+        masks.quote |= bits(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('"')));
+        masks.slash |= bits(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('/')));
+    }
+    return masks;
+#else
+    bracket_masks masks{};
+    for (int i = 0; i < 64; i++) {
+        const std::uint64_t bit = std::uint64_t{1} << i;
+        switch (data[i]) {
+            case '{': case '[':
+                masks.open |= bit;
+                break;
+            case '}': case ']':
+                masks.close |= bit;
+                break;
+            case '"':
+                masks.quote |= bit;
+                break;
+            case '/':
+                masks.slash |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+    return masks;
+#endif
+}
+
+//Sets every bit from each set bit up to the next one: with quote bits, marks the bytes inside strings.
+std::uint64_t prefix_xor(std::uint64_t bits) {
+    for (int shift = 1; shift < 64; shift *= 2)
+        bits ^= bits << shift;
+    return bits;
+}
+
+//Returns the position behind the bracket closing the object or array whose contents start at p, or nullptr. Only
+//brackets are tracked, 64 bytes at a time; brackets inside strings and comments do not count. The string dialect
+//has no escapes, so every quote toggles between inside and outside a string. A slash outside a string has to start
+//a // comment, as in the tokenizer.
+const char *skip_container(const char *p, const char *end) {
+    size_t depth = 1;
+    std::uint64_t in_string = 0;
+    while (p < end) {
+        const char *data = p;
+        //Pad the last block with whitespace so no bits are set past the end of the input.
+        char padded[64];
+        if (end - p < 64) {
+            std::memset(padded, ' ', sizeof(padded));
+            std::memcpy(padded, p, static_cast<size_t>(end - p));
+            data = padded;
+        }
+        const auto masks = classify_brackets(data);
+        const std::uint64_t strings = prefix_xor(masks.quote) ^ in_string;
+        //Brackets behind the first slash belong to a comment or to invalid input.
+        const std::uint64_t comments = masks.slash & ~strings;
+        const std::uint64_t before_comment = comments == 0 ? ~std::uint64_t{0} : (comments & -comments) - 1;
+        const std::uint64_t open = masks.open & ~strings & before_comment;
+        const std::uint64_t close = masks.close & ~strings & before_comment;
+        if (static_cast<size_t>(std::popcount(close)) >= depth) {
+            for (std::uint64_t brackets = open | close; brackets != 0; brackets &= brackets - 1) {
+                const std::uint64_t bracket = brackets & -brackets;
+                if ((bracket & open) != 0)
+                    depth++;
+                else if (--depth == 0)
+                    return p + std::countr_zero(bracket) + 1;
+            }
+        } else {
+            depth += static_cast<size_t>(std::popcount(open)) - static_cast<size_t>(std::popcount(close));
+        }
+        if (comments != 0) {
+            const char *comment = p + std::countr_zero(comments);
+            if (comment + 1 == end || comment[1] != '/')
+                return nullptr;
+            const auto *newline = static_cast<const char *>(std::memchr(comment, '\n', static_cast<size_t>(end - comment)));
+            if (newline == nullptr)
+                return nullptr;
+            p = newline + 1;
+            in_string = 0;
+        } else {
+            in_string = std::uint64_t{0} - (strings >> 63);
+            p += 64;
+        }
+    }
+    return nullptr;
+}
+
+//Consumes the value at the front of tokens and returns the position behind it, or nullptr. Objects and arrays are
+//skipped with skip_container and tokens restarts behind them.
+const char *skip_lazy_value(jayson::tokenizer &tokens, const char *end) {
+    const auto t = peek_next_non_comment_token(tokens);
+    if (!t.has_value())
+        return nullptr;
+    const auto original = t.value().get_original();
+    switch (t.value().get_type()) {
+        case jayson::token_type::OBJECT_BEGIN:
+        case jayson::token_type::ARRAY_BEGIN: {
+            const char *behind = skip_container(original.data() + 1, end);
+            if (behind != nullptr)
+                tokens = jayson::tokenize(jayson::string_type(behind, static_cast<size_t>(end - behind)));
+            return behind;
+        }
+        case jayson::token_type::OBJECT_END:
+        case jayson::token_type::ARRAY_END:
+        case jayson::token_type::COMMA:
+        case jayson::token_type::COLON:
+            return nullptr;
+        default:
+            tokens.skip_next_token();
+            return original.data() + original.size();
+    }
+}
+
+//The value at the front of tokens, if one starts there.
+std::optional<jayson::lazy_value> lazy_value_at(jayson::tokenizer &tokens, const char *end) {
+    const auto t = peek_next_non_comment_token(tokens);
+    if (!t.has_value())
+        return std::nullopt;
+    switch (t.value().get_type()) {
+        case jayson::token_type::OBJECT_END:
+        case jayson::token_type::ARRAY_END:
+        case jayson::token_type::COMMA:
+        case jayson::token_type::COLON:
+            return std::nullopt;
+        default: {
+            const char *begin = t.value().get_original().data();
+            return jayson::lazy_value(jayson::string_type(begin, static_cast<size_t>(end - begin)));
+        }
+    }
+}
+
+std::optional<jayson::jayson_types> jayson::lazy_value::get_type() const {
+    auto tokens = tokenize(this->input);
+    const auto t = peek_next_non_comment_token(tokens);
+    if (!t.has_value())
+        return std::nullopt;
+    switch (t.value().get_type()) {
+        case token_type::OBJECT_BEGIN:
+            return jayson_types::OBJECT;
+        case token_type::ARRAY_BEGIN:
+            return jayson_types::ARRAY;
+        case token_type::STRING:
+            return jayson_types::STRING;
+        case token_type::INTEGER:
+            return jayson_types::INTEGER;
+        case token_type::FLOAT:
+            return jayson_types::FLOAT;
+        case token_type::BOOLEAN:
+            return jayson_types::BOOLEAN;
+        case token_type::NONE:
+            return jayson_types::NONE;
+        default:
+            return std::nullopt;
+    }
+}
+
+std::optional<jayson::lazy_value> jayson::lazy_value::find_field(const string_type &key) const {
+    const char *end = this->input.data() + this->input.size();
+    auto tokens = tokenize(this->input);
+    auto t = get_next_non_comment_token(tokens);
+    if (!t.has_value() || t.value().get_type() != token_type::OBJECT_BEGIN)
+        return std::nullopt;
+    t = get_next_non_comment_token(tokens);
+    if (!t.has_value() || t.value().get_type() == token_type::OBJECT_END)
+        return std::nullopt;
+    while (true) {
+        if (t.value().get_type() != token_type::STRING)
+            return std::nullopt;
+        const bool found = t.value().get_string() == key;
+        t = get_next_non_comment_token(tokens);
+        if (!t.has_value() || t.value().get_type() != token_type::COLON)
+            return std::nullopt;
+        if (found)
+            return lazy_value_at(tokens, end);
+        if (skip_lazy_value(tokens, end) == nullptr)
+            return std::nullopt;
+        t = get_next_non_comment_token(tokens);
+        if (!t.has_value() || t.value().get_type() != token_type::COMMA)
+            return std::nullopt;
+        t = get_next_non_comment_token(tokens);
+        if (!t.has_value())
+            return std::nullopt;
+    }
+}
+
+std::optional<jayson::lazy_value> jayson::lazy_value::at(integer_type index) const {
+    const char *end = this->input.data() + this->input.size();
+    auto tokens = tokenize(this->input);
+    auto t = get_next_non_comment_token(tokens);
+    if (!t.has_value() || t.value().get_type() != token_type::ARRAY_BEGIN || index < 0)
+        return std::nullopt;
+    for (; index > 0; index--) {
+        if (skip_lazy_value(tokens, end) == nullptr)
+            return std::nullopt;
+        t = get_next_non_comment_token(tokens);
+        if (!t.has_value() || t.value().get_type() != token_type::COMMA)
+            return std::nullopt;
+    }
+    return lazy_value_at(tokens, end);
+}
+
+std::optional<jayson::string_type> jayson::lazy_value::get_string() const {
+    auto tokens = tokenize(this->input);
+    const auto t = peek_next_non_comment_token(tokens);
+    return t.has_value() ? t.value().get_string() : std::nullopt;
+}
+
+std::optional<jayson::integer_type> jayson::lazy_value::get_integer() const {
+    auto tokens = tokenize(this->input);
+    const auto t = peek_next_non_comment_token(tokens);
+    return t.has_value() ? t.value().get_integer() : std::nullopt;
+}
+
+std::optional<jayson::float_type> jayson::lazy_value::get_float() const {
+    auto tokens = tokenize(this->input);
+    const auto t = peek_next_non_comment_token(tokens);
+    return t.has_value() ? t.value().get_float() : std::nullopt;
+}
+
+std::optional<bool> jayson::lazy_value::get_boolean() const {
+    auto tokens = tokenize(this->input);
+    const auto t = peek_next_non_comment_token(tokens);
+    return t.has_value() ? t.value().get_boolean() : std::nullopt;
+}
+
+jayson::document jayson::lazy_value::materialize() const {
+    const char *end = this->input.data() + this->input.size();
+    auto tokens = tokenize(this->input);
+    const auto value = lazy_value_at(tokens, end);
+    const char *behind = value.has_value() ? skip_lazy_value(tokens, end) : nullptr;
+    if (behind == nullptr)
+        return parse_document(string_type());
+    const char *begin = value.value().input.data();
+    return parse_document(string_type(begin, static_cast<size_t>(behind - begin)));
+}
+
+//Characters a number token can be made of; the tokenizer splits a run of them into numbers where it has to.
+bool is_number_character(char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+jayson::string_type literal_for(char first) {
+    switch (first) {
+        case 't':
+            return "true";
+        case 'f':
+            return "false";
+        case 'n':
+            return "null";
+        default:
+            return {};
+    }
+}
+
+bool jayson::detail::token_reaches_end(string_type rest) {
+    switch (rest[0]) {
+        case '"':
+            return rest.find('"', 1) == string_type::npos;
+        case '/':
+            return rest.size() == 1 || (rest[1] == '/' && rest.find('\n') == string_type::npos);
+        case 't':
+        case 'f':
+        case 'n': {
+            const auto literal = literal_for(rest[0]);
+            return rest.size() < literal.size() && literal.starts_with(rest);
+        }
+        default:
+            return (rest[0] == '-' || (rest[0] >= '0' && rest[0] <= '9')) &&
+                   std::all_of(rest.begin(), rest.end(), is_number_character);
+    }
+}
+
+jayson::detail::token_rest jayson::detail::pending_token_rest(string_type pending, string_type chunk) {
+    switch (pending[0]) {
+        case '"': {
+            const auto quote = chunk.find('"');
+            if (quote == string_type::npos)
+                return {chunk.size(), true};
+            return {quote + 1, false};
+        }
+        case '/': {
+            //A single slash is completed or refuted by the next byte.
+            const size_t from = pending.size() == 1 ? 1 : 0;
+            if (from == 1 && chunk[0] != '/')
+                return {1, false};
+            const auto newline = chunk.find('\n', from);
+            if (newline == string_type::npos)
+                return {chunk.size(), true};
+            return {newline + 1, false};
+        }
+        case 't':
+        case 'f':
+        case 'n': {
+            const auto literal = literal_for(pending[0]);
+            const size_t length = std::min(chunk.size(), literal.size() - pending.size());
+            //Literals are a few bytes long, comparing the whole of them again is cheap.
+            const bool matches = literal.substr(pending.size(), length) == chunk.substr(0, length);
+            return {length, matches && pending.size() + length < literal.size()};
+        }
+        default: {
+            const auto length = static_cast<size_t>(std::find_if_not(chunk.begin(), chunk.end(), is_number_character) - chunk.begin());
+            return {length, length == chunk.size()};
+        }
+    }
+}
+
+//Input per thread below which parse_many does not start another thread.
+constexpr size_t min_bytes_per_thread = 64 * 1024;
+
+//Parses the lines of [begin, end) into nodes, appending one root per line that is not blank. The scratch vectors of
+//the parser are kept across lines.
+void parse_lines(const char *begin, const char *end, jayson::arena &nodes, std::vector<const jayson::jayson_element *> &roots) {
+    std::vector<jayson::jayson_element> elements;
+    std::vector<jayson::jayson_member> members;
+    std::vector<std::uint32_t> index;
+    while (begin != end) {
+        const auto *newline = static_cast<const char *>(std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+        const char *line_end = newline == nullptr ? end : newline;
+        const jayson::string_type line(begin, static_cast<size_t>(line_end - begin));
+        begin = newline == nullptr ? end : newline + 1;
+        if (line.find_first_not_of(" \t\r") == jayson::string_type::npos)
+            continue;
+        auto tokens = jayson::tokenize(line);
+        parser_state state{tokens, nodes, std::move(elements), std::move(members), std::move(index)};
+        auto value = parse_jayson_value(state);
+        if (value.has_value() && !peek_next_non_comment_token(tokens).has_value())
+            roots.push_back(nodes.create<jayson::jayson_element>(std::move(value.value())));
+        else
+            roots.push_back(nullptr);
+        //A failed parse can leave members and elements of unfinished containers behind.
+        elements = std::move(state.elements);
+        members = std::move(state.members);
+        index = std::move(state.index);
+        elements.clear();
+        members.clear();
+    }
+}
+
+jayson::document_batch jayson::parse_many(std::string_view input, unsigned threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, input.size() / min_bytes_per_thread + 1));
+
+    //Every thread takes the lines from behind the first newline after its share of the input.
+    const char *end = input.data() + input.size();
+    std::vector<const char *> cuts{input.data()};
+    for (unsigned i = 1; i < threads; i++) {
+        const char *from = std::max(cuts.back(), input.data() + input.size() * i / threads);
+        const auto *newline = static_cast<const char *>(std::memchr(from, '\n', static_cast<size_t>(end - from)));
+        cuts.push_back(newline == nullptr ? end : newline + 1);
+    }
+    cuts.push_back(end);
+
+    document_batch result;
+    result.arenas.resize(threads);
+    std::vector<std::vector<const jayson_element *>> roots(threads);
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < threads; i++)
+        workers.emplace_back(parse_lines, cuts[i], cuts[i + 1], std::ref(result.arenas[i]), std::ref(roots[i]));
+    parse_lines(cuts[0], cuts[1], result.arenas[0], roots[0]);
+    for (auto &worker : workers)
+        worker.join();
+
+    result.roots = std::move(roots[0]);
+    for (unsigned i = 1; i < threads; i++)
+        result.roots.insert(result.roots.end(), roots[i].begin(), roots[i].end());
+    return result;
+}
@@ -2,32 +2,27 @@
 #include "../include/jayson_dump.hpp"
 #include "../include/jayson_print.hpp"
 #include "../include/jayson_comparators.hpp"
+#include "../include/jayson_file.hpp"
 
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <ostream>
 #include <string_view>
 
 int main(int argc, char **argv) {
-    // cheat here and use stdin directly instead of cin
-    // (because we would either need an object or a reference which does not work)
-    auto file  = argc > 1 ? std::ifstream {argv[1]} : std::ifstream {"/dev/stdin"};
-    auto input = std::string();
-    while (true) {
-        char c = file.get();
-        if (!file)
-            break;
-        else
-            input += c;
+    auto file = jayson::mapped_file {argc > 1 ? argv[1] : "/dev/stdin"};
+    if (!file.is_open()) {
+        std::cerr << "could not read " << (argc > 1 ? argv[1] : "/dev/stdin") << std::endl;
+        return 1;
     }
+    auto input = file.view();
     std::cout << "tokenizing:" << std::endl;
-    auto tokenized = jayson::tokenize(std::string_view {input.c_str(), input.size()});
+    auto tokenized = jayson::tokenize(input);
     for (auto token = tokenized.get_next_token(); token; token = tokenized.get_next_token()) {
         std::cout << token.value() << std::endl;
     }
     std::cout << "parsing:" << std::endl;
-    auto parsed = jayson::parse_direct(std::string_view {input.c_str(), input.size()});
+    auto parsed = jayson::parse_direct(input);
     assert(parsed);
     std::cout << *parsed.get() << std::endl;
     std::cout << "pretty-printed" << std::endl;
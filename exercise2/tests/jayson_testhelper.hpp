@@ -59,6 +59,15 @@ inline void check_comment_token(const jayson::token &token, const std::string &e
 }
 
 
+// Presents a parsed document like the unique_ptr returned by parse()
+struct document_result {
+    jayson::document document;
+
+    [[nodiscard]] const jayson::jayson_element *get() const { return document.root(); }
+    const jayson::jayson_element *operator->() const { return document.root(); }
+    explicit operator bool() const { return document.root() != nullptr; }
+};
+
 template<typename Lambda>
 inline auto test_parse_both(std::string_view input, Lambda &&l) {
     using namespace std::literals;
@@ -66,6 +75,7 @@ inline auto test_parse_both(std::string_view input, Lambda &&l) {
     l("tokenized"s, std::move(tokenized));
     auto direct = jayson::parse_direct(input);
     l("direct"s, std::move(direct));
+    l("document"s, document_result{jayson::parse_document(input)});
 }
 
 
@@ -137,5 +147,20 @@ inline void check_null_value(std::string_view input) {
     });
 }
 
+// Writes every event as a short mark so that whole streams can be compared
+struct recording_handler {
+    std::string events;
+
+    void on_object_begin() { events += "{ "; }
+    void on_key(jayson::string_type key) { events += "key:" + std::string(key) + " "; }
+    void on_object_end() { events += "} "; }
+    void on_array_begin() { events += "[ "; }
+    void on_array_end() { events += "] "; }
+    void on_string(jayson::string_type value) { events += "\"" + std::string(value) + "\" "; }
+    void on_integer(jayson::integer_type value) { events += std::to_string(value) + " "; }
+    void on_float(jayson::float_type value) { events += "f" + std::to_string(value) + " "; }
+    void on_boolean(bool value) { events += value ? "true " : "false "; }
+    void on_none() { events += "null "; }
+};
 
 #endif
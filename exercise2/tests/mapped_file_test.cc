@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <cstdlib>
+#include <utility>
+
+#include <unistd.h>
+
+#include "jayson.hpp"
+#include "jayson_file.hpp"
+
+using namespace std::literals;
+
+//------------------------------------------------------------------------------
+// READING
+//------------------------------------------------------------------------------
+
+TEST(MappedFile, RegularFile) {
+    jayson::mapped_file file("tests/red-dress.jayson");
+    ASSERT_TRUE(file.is_open());
+    EXPECT_TRUE(jayson::parse_direct(file.view()));
+}
+
+TEST(MappedFile, Pipe) {
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    const auto input = "[1, 2, 3]"sv;
+    ASSERT_EQ(::write(fds[1], input.data(), input.size()), static_cast<ssize_t>(input.size()));
+    ::close(fds[1]);
+    jayson::mapped_file file(("/dev/fd/" + std::to_string(fds[0])).c_str());
+    ::close(fds[0]);
+    ASSERT_TRUE(file.is_open());
+    EXPECT_EQ(file.view(), input);
+}
+
+TEST(MappedFile, PageSizedFileEndingInNumber) {
+    // the number ends at the last byte of the mapping, the scanner must not look at the byte behind it
+    const auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const std::pair<std::string_view, jayson::jayson_types> numbers[] = {
+        {"1234567890"sv, jayson::jayson_types::INTEGER},
+        {"-12.5e3"sv, jayson::jayson_types::FLOAT},
+    };
+    for (auto [number, type] : numbers) {
+        char path[] = "/tmp/mapped_file_testXXXXXX";
+        const int fd = ::mkstemp(path);
+        ASSERT_GE(fd, 0);
+        const auto content = std::string(page_size - number.size(), ' ') + std::string(number);
+        ASSERT_EQ(::write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+        ::close(fd);
+        jayson::mapped_file file(path);
+        ::unlink(path);
+        ASSERT_TRUE(file.is_open());
+        ASSERT_EQ(file.view(), content);
+
+        auto tokens = jayson::tokenize(file.view());
+        auto t = tokens.get_next_token();
+        ASSERT_TRUE(t.has_value());
+        EXPECT_EQ(t.value().get_original(), number);
+        EXPECT_FALSE(tokens.get_next_token().has_value());
+        auto parsed = jayson::parse_direct(file.view());
+        ASSERT_TRUE(parsed);
+        EXPECT_EQ(parsed->get_type(), type);
+    }
+}
+
+TEST(MappedFile, MissingFile) {
+    EXPECT_FALSE(jayson::mapped_file("tests/does-not-exist.jayson").is_open());
+}
+
+TEST(MappedFile, ReadErrorIsNotEndOfInput) {
+    // a directory opens like a stream but every read fails with EISDIR
+    jayson::mapped_file file("tests");
+    EXPECT_FALSE(file.is_open());
+    EXPECT_TRUE(file.view().empty());
+}
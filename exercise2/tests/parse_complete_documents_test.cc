@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <fstream>
@@ -396,6 +397,45 @@ TEST(ParseCompleteDocuments, RealWorldDatasetExcerpt) {
     });
 }
 
+TEST(ParseCompleteDocuments, ParsedRootOwnsTree) {
+    // the arena hangs off the heap allocation of the root, the nodes themselves carry no owner
+    static_assert(sizeof(jayson::jayson_element) <= 3 * sizeof(void *));
+    const std::string input = R"({"list": [1, 2, {"deep": ["x", "y"]}], "name": "owned"})";
+    std::unique_ptr<jayson::jayson_element> root;
+    root = jayson::parse_direct(input);
+    ASSERT_TRUE(root);
+    auto list = root->to_object()->get_value_for("list")->to_array();
+    ASSERT_EQ(list->size(), 3);
+    EXPECT_EQ(list->get_value_at(2)->to_object()->get_value_for("deep")->to_array()->size(), 2);
+    root.reset();
+
+    // elements created outside of parse() own nothing
+    auto single = std::make_unique<jayson::jayson_element>(jayson::jayson_integer(7));
+    EXPECT_EQ(single->to_integer()->get_integer(), 7);
+}
+
+TEST(ParseCompleteDocuments, DocumentSurvivesMove) {
+    auto document = jayson::parse_document(R"({"list": [1, 2, 3], "name": "moved"})");
+    const auto *root = document.root();
+    ASSERT_TRUE(root);
+
+    auto moved = std::move(document);
+    ASSERT_EQ(moved.root(), root);
+    EXPECT_FALSE(document.root());
+    auto list = root->to_object()->get_value_for("list")->to_array();
+    ASSERT_EQ(list->size(), 3);
+    EXPECT_EQ(list->get_value_at(2)->to_integer()->get_integer(), 3);
+    EXPECT_EQ(root->to_object()->get_value_for("name")->to_string()->get_string(), "moved");
+
+    auto assigned = jayson::parse_document("[4]");
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.root(), root);
+    EXPECT_FALSE(moved.root());
+    EXPECT_EQ(root->to_object()->get_value_for("name")->to_string()->get_string(), "moved");
+
+    EXPECT_FALSE(jayson::parse_document("[1, 2").root());
+}
+
 //------------------------------------------------------------------------------
 // INVALID COMPLETE DOCUMENTS
 //------------------------------------------------------------------------------
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <sstream>
+
+#include "jayson.hpp"
+#include "jayson_fixed.hpp"
+#include "jayson_events.hpp"
+#include "jayson_testhelper.hpp"
+
+using namespace std::literals;
+
+// Counts values the way the element tree would hold them
+struct counting_handler {
+    std::size_t values = 0;
+    std::size_t keys   = 0;
+
+    void on_object_begin() { values++; }
+    void on_key(jayson::string_type) { keys++; }
+    void on_object_end() {}
+    void on_array_begin() { values++; }
+    void on_array_end() {}
+    void on_string(jayson::string_type) { values++; }
+    void on_integer(jayson::integer_type) { values++; }
+    void on_float(jayson::float_type) { values++; }
+    void on_boolean(bool) { values++; }
+    void on_none() { values++; }
+};
+
+std::string record(std::string_view input, bool expected_result = true) {
+    recording_handler handler;
+    EXPECT_EQ(jayson::parse_events(input, handler), expected_result) << input;
+    return handler.events;
+}
+
+std::size_t count_tree_values(const jayson::jayson_element *element) {
+    std::size_t values = 1;
+    if (auto object = element->to_object())
+        for (auto value : object->get_values()) values += count_tree_values(value);
+    if (auto array = element->to_array())
+        for (auto value : array->get_elements()) values += count_tree_values(value);
+    return values;
+}
+
+//------------------------------------------------------------------------------
+// EVENT STREAMS
+//------------------------------------------------------------------------------
+
+TEST(ParseEvents, SingleValues) {
+    EXPECT_EQ(record("42"), "42 ");
+    EXPECT_EQ(record("-1.5"), "f-1.500000 ");
+    EXPECT_EQ(record("\"text\""), "\"text\" ");
+    EXPECT_EQ(record("true"), "true ");
+    EXPECT_EQ(record("// comment\nnull"), "null ");
+}
+
+TEST(ParseEvents, Structures) {
+    EXPECT_EQ(record("{}"), "{ } ");
+    EXPECT_EQ(record("[]"), "[ ] ");
+    EXPECT_EQ(record(R"({"a": 1, "b": [true, {}, []], "c": {"d": null}})"),
+              "{ key:a 1 key:b [ true { } [ ] ] key:c { key:d null } } ");
+    EXPECT_EQ(record("[1, // comment\n \"two\", [3.5]]"), "[ 1 \"two\" [ f3.500000 ] ] ");
+}
+
+TEST(ParseEvents, DeepNestingNeedsNoRecursion) {
+    const size_t depth = 100000;
+    std::string input = std::string(depth, '[') + std::string(depth, ']');
+    counting_handler handler;
+    EXPECT_TRUE(jayson::parse_events(input, handler));
+    EXPECT_EQ(handler.values, depth);
+}
+
+TEST(ParseEvents, MatchesElementTree) {
+    std::ifstream t("tests/red-dress.jayson");
+    std::stringstream buffer;
+    buffer << t.rdbuf();
+    auto input = buffer.str();
+
+    counting_handler handler;
+    ASSERT_TRUE(jayson::parse_events(input, handler));
+    auto tree = jayson::parse_direct(input);
+    ASSERT_TRUE(tree);
+    EXPECT_EQ(handler.values, count_tree_values(tree.get()));
+}
+
+//------------------------------------------------------------------------------
+// INVALID INPUT
+//------------------------------------------------------------------------------
+
+TEST(ParseEvents, InvalidInput) {
+    EXPECT_EQ(record("", false), "");
+    EXPECT_EQ(record("[1, 2", false), "[ 1 2 ");
+    record("[1 2]", false);
+    record("[1, 2,]", false);
+    record("{\"a\" 1}", false);
+    record("{1: 2}", false);
+    record("{\"a\": 1,}", false);
+    record("{\"a\": 1]", false);
+    record("[1}", false);
+    record("1 2", false);
+    record("]", false);
+    record(",", false);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <sstream>
+
+#include "jayson.hpp"
+#include "jayson_fixed.hpp"
+#include "jayson_events.hpp"
+#include "jayson_feed.hpp"
+#include "jayson_testhelper.hpp"
+
+using namespace std::literals;
+
+// Every kind of token, including numbers, literals and comments that can be cut anywhere
+const std::string all_tokens = "// leading comment\n"
+                               "{\"name\": \"Red [Dress]\", \"sizes\": [36, -38, 40.5, -1.25e-3, 2E+2],\n"
+                               " \"flags\": {\"sale\": true, \"new\": false, \"note\": null}, // trailing\n"
+                               " \"empty\": [{}, []], \"big\": 239476273194337494}";
+
+std::string read_red_dress() {
+    std::ifstream t("tests/red-dress.jayson");
+    std::stringstream buffer;
+    buffer << t.rdbuf();
+    return buffer.str();
+}
+
+std::string record_whole(std::string_view input) {
+    recording_handler handler;
+    EXPECT_TRUE(jayson::parse_events(input, handler));
+    return handler.events;
+}
+
+// Feeds input in chunks of chunk_size bytes
+std::string record_in_chunks(std::string_view input, size_t chunk_size) {
+    recording_handler handler;
+    jayson::feed_parser parser(handler);
+    for (size_t offset = 0; offset < input.size(); offset += chunk_size)
+        EXPECT_TRUE(parser.feed(input.substr(offset, chunk_size))) << offset;
+    EXPECT_TRUE(parser.finish());
+    EXPECT_EQ(parser.values(), 1);
+    return handler.events;
+}
+
+//------------------------------------------------------------------------------
+// SPLIT INPUT
+//------------------------------------------------------------------------------
+
+TEST(ParseFeed, SplitAtEveryOffset) {
+    const auto expected = record_whole(all_tokens);
+    for (size_t split = 0; split <= all_tokens.size(); ++split) {
+        recording_handler handler;
+        jayson::feed_parser parser(handler);
+        EXPECT_TRUE(parser.feed(std::string_view(all_tokens).substr(0, split)));
+        EXPECT_TRUE(parser.feed(std::string_view(all_tokens).substr(split)));
+        EXPECT_TRUE(parser.finish());
+        EXPECT_EQ(handler.events, expected) << split;
+    }
+}
+
+TEST(ParseFeed, ByteAtATime) {
+    EXPECT_EQ(record_in_chunks(all_tokens, 1), record_whole(all_tokens));
+}
+
+TEST(ParseFeed, RedDressSplitAtEveryOffset) {
+    // Feeding one byte at a time puts a chunk boundary at every offset of the document in one pass
+    const auto input = read_red_dress();
+    const auto expected = record_whole(input);
+    EXPECT_EQ(record_in_chunks(input, 1), expected);
+    for (size_t chunk_size : {7, 64, 4093, 65536})
+        EXPECT_EQ(record_in_chunks(input, chunk_size), expected) << chunk_size;
+}
+
+TEST(ParseFeed, LongTokensByteAtATime) {
+    // every byte continues the pending token; rescanning it on every feed is quadratic and takes seconds here
+    const std::string long_text(1 << 20, 'a');
+    const auto input = "[\"" + long_text + "\", // " + long_text + "\n 12345678, -0.5e-3, true, null]";
+    recording_handler handler;
+    jayson::feed_parser parser(handler);
+    for (char c : input)
+        ASSERT_TRUE(parser.feed(std::string_view(&c, 1)));
+    EXPECT_TRUE(parser.finish());
+    EXPECT_EQ(handler.events, record_whole(input));
+}
+
+//------------------------------------------------------------------------------
+// VALUES AS THEY COMPLETE
+//------------------------------------------------------------------------------
+
+TEST(ParseFeed, ReportsValuesAsTheyComplete) {
+    recording_handler handler;
+    jayson::feed_parser parser(handler);
+    EXPECT_TRUE(parser.feed("[1, \"tw"));
+    EXPECT_EQ(handler.events, "[ 1 ");
+    EXPECT_TRUE(parser.feed("o\", 3"));
+    EXPECT_EQ(handler.events, "[ 1 \"two\" ");
+    EXPECT_TRUE(parser.feed("4]"));
+    EXPECT_EQ(handler.events, "[ 1 \"two\" 34 ] ");
+    EXPECT_EQ(parser.values(), 1);
+    EXPECT_TRUE(parser.finish());
+}
+
+TEST(ParseFeed, SequenceOfValues) {
+    recording_handler handler;
+    jayson::feed_parser parser(handler);
+    EXPECT_TRUE(parser.feed("{\"a\": 1}\n[2]\n1"));
+    EXPECT_EQ(parser.values(), 2);
+    EXPECT_TRUE(parser.feed("2"));
+    EXPECT_EQ(parser.values(), 2);
+    EXPECT_TRUE(parser.feed(" nu"));
+    EXPECT_EQ(parser.values(), 3);
+    EXPECT_TRUE(parser.feed("ll"));
+    EXPECT_EQ(parser.values(), 4);
+    EXPECT_TRUE(parser.feed("// comment at the end"));
+    EXPECT_TRUE(parser.finish());
+    EXPECT_EQ(handler.events, "{ key:a 1 } [ 2 ] 12 null ");
+}
+
+TEST(ParseFeed, NumberCompletedByFinish) {
+    recording_handler handler;
+    jayson::feed_parser parser(handler);
+    EXPECT_TRUE(parser.feed("-1"));
+    EXPECT_TRUE(parser.feed(".5"));
+    EXPECT_TRUE(parser.feed("e1"));
+    EXPECT_EQ(parser.values(), 0);
+    EXPECT_TRUE(parser.finish());
+    EXPECT_EQ(handler.events, "f-15.000000 ");
+    EXPECT_EQ(parser.values(), 1);
+}
+
+//------------------------------------------------------------------------------
+// INVALID INPUT
+//------------------------------------------------------------------------------
+
+bool feed_and_finish(std::initializer_list<std::string_view> chunks) {
+    recording_handler handler;
+    jayson::feed_parser parser(handler);
+    for (auto chunk : chunks)
+        parser.feed(chunk);
+    return parser.finish();
+}
+
+TEST(ParseFeed, InvalidInput) {
+    EXPECT_FALSE(feed_and_finish({"[1", "}"}));
+    EXPECT_FALSE(feed_and_finish({"[1, 2"}));
+    EXPECT_FALSE(feed_and_finish({"{\"a", "\": "}));
+    EXPECT_FALSE(feed_and_finish({"\"unterminated"}));
+    EXPECT_FALSE(feed_and_finish({"[t", "rux]"}));
+    EXPECT_FALSE(feed_and_finish({"[1, /", "x]"}));
+    EXPECT_FALSE(feed_and_finish({"[1.", "]"}));
+    EXPECT_FALSE(feed_and_finish({"@"}));
+    EXPECT_TRUE(feed_and_finish({}));
+
+    recording_handler handler;
+    jayson::feed_parser parser(handler);
+    EXPECT_FALSE(parser.feed("[1 2 "));
+    EXPECT_FALSE(parser.feed("]"));
+    EXPECT_FALSE(parser.finish());
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <sstream>
+
+#include "jayson.hpp"
+#include "jayson_fixed.hpp"
+#include "jayson_lazy.hpp"
+
+using namespace std::literals;
+
+//------------------------------------------------------------------------------
+// NAVIGATION
+//------------------------------------------------------------------------------
+
+TEST(ParseLazy, SingleValues) {
+    EXPECT_EQ(jayson::lazy_document("42").root().get_integer(), 42);
+    EXPECT_EQ(jayson::lazy_document(" -1.5").root().get_float(), -1.5);
+    EXPECT_EQ(jayson::lazy_document("\"text\"").root().get_string(), "text");
+    EXPECT_EQ(jayson::lazy_document("// comment\ntrue").root().get_boolean(), true);
+    EXPECT_EQ(jayson::lazy_document("null").root().get_type(), jayson::jayson_types::NONE);
+    EXPECT_FALSE(jayson::lazy_document("7").root().get_string());
+    EXPECT_FALSE(jayson::lazy_document("").root().get_type());
+}
+
+TEST(ParseLazy, FindField) {
+    jayson::lazy_document document(R"({"a": 1, "b": {"c": [true, "x"]}, "d": "last"})");
+    EXPECT_EQ(document.find_field("a")->get_integer(), 1);
+    EXPECT_EQ(document.find_field("d")->get_string(), "last");
+    EXPECT_EQ(document.find_field("b")->get_type(), jayson::jayson_types::OBJECT);
+    EXPECT_EQ(document.find_field("b")->find_field("c")->at(1)->get_string(), "x");
+    EXPECT_FALSE(document.find_field("missing"));
+    EXPECT_FALSE(document.find_field("c"));
+    EXPECT_FALSE(document.at(0));
+    EXPECT_FALSE(jayson::lazy_document("{}").find_field("a"));
+}
+
+TEST(ParseLazy, At) {
+    jayson::lazy_document document(R"([[1, [2]], {"k": "]"}, 3.5, null])");
+    EXPECT_EQ(document.at(0)->at(1)->at(0)->get_integer(), 2);
+    EXPECT_EQ(document.at(1)->find_field("k")->get_string(), "]");
+    EXPECT_EQ(document.at(2)->get_float(), 3.5);
+    EXPECT_EQ(document.at(3)->get_type(), jayson::jayson_types::NONE);
+    EXPECT_FALSE(document.at(4));
+    EXPECT_FALSE(document.at(-1));
+    EXPECT_FALSE(jayson::lazy_document("[]").at(0));
+}
+
+TEST(ParseLazy, SkipsBracketsInStringsAndComments) {
+    jayson::lazy_document document("{\"skipped\": [\"}]\", // ] } [\n {\"x\": \"[{\"}],\n"
+                                   " \"wanted\": 5}");
+    EXPECT_EQ(document.find_field("wanted")->get_integer(), 5);
+}
+
+TEST(ParseLazy, SkipsAcrossBlocks) {
+    // Strings and comments full of brackets that straddle the 64-byte blocks of the bracket scan
+    std::string brackets(100, ']');
+    for (size_t padding = 0; padding < 64; ++padding) {
+        auto input = "{\"skipped\": [" + std::string(padding, ' ') + "\"" + brackets + "\", [{}],\n// " + brackets +
+                     "\n{\"" + brackets + "\": [\"[\"]}], \"wanted\": " + std::to_string(padding) + "}";
+        EXPECT_EQ(jayson::lazy_document(input).find_field("wanted")->get_integer(), padding) << input;
+    }
+}
+
+TEST(ParseLazy, Materialize) {
+    jayson::lazy_document document(R"({"skip": [1, 2], "object": {"list": [1, 2, 3]}, "after": 1})");
+    auto object = document.find_field("object")->materialize();
+    ASSERT_TRUE(object.root());
+    auto list = object.root()->to_object()->get_value_for("list")->to_array();
+    ASSERT_TRUE(list);
+    EXPECT_EQ(list->size(), 3);
+
+    auto scalar = document.find_field("after")->materialize();
+    ASSERT_TRUE(scalar.root());
+    EXPECT_EQ(scalar.root()->to_integer()->get_integer(), 1);
+}
+
+//------------------------------------------------------------------------------
+// REAL WORLD DOCUMENT
+//------------------------------------------------------------------------------
+
+TEST(ParseLazy, RedDressFields) {
+    std::ifstream t("tests/red-dress.jayson");
+    std::stringstream buffer;
+    buffer << t.rdbuf();
+    auto input = buffer.str();
+
+    jayson::lazy_document document(input);
+    EXPECT_EQ(document.find_field("name")->get_string(), "Red Dress");
+    EXPECT_EQ(document.find_field("commit_hash")->get_string(), "8fa46ba63a69bb5fa18a49194cf112d963a2d43b");
+    auto node = document.find_field("network_interface")->find_field("network")->find_field("exports")->at(0)->find_field("Node");
+    ASSERT_TRUE(node);
+    EXPECT_EQ(node->find_field("node_id")->get_integer(), 239476273194337494LL);
+    EXPECT_EQ(node->find_field("lambda")->get_boolean(), false);
+}
+
+//------------------------------------------------------------------------------
+// INVALID INPUT
+//------------------------------------------------------------------------------
+
+TEST(ParseLazy, InvalidInput) {
+    EXPECT_FALSE(jayson::lazy_document(R"({"a": [1, 2, "b": 3})").find_field("b"));
+    EXPECT_FALSE(jayson::lazy_document(R"({"a" 1})").find_field("a"));
+    EXPECT_FALSE(jayson::lazy_document(R"({"a": 1 "b": 2})").find_field("b"));
+    EXPECT_FALSE(jayson::lazy_document(R"({"a": "unterminated})").find_field("b"));
+    EXPECT_FALSE(jayson::lazy_document(R"([1 2])").at(1));
+    EXPECT_FALSE(jayson::lazy_document(R"({"a": ,})").find_field("a"));
+    EXPECT_FALSE(jayson::lazy_document(R"({"a": [1, 2)").find_field("a")->materialize().root());
+}
+
+TEST(ParseLazy, SingleSlashIsNotAComment) {
+    EXPECT_FALSE(jayson::lazy_document("[1, /]").at(1));
+    EXPECT_FALSE(jayson::lazy_document("[[1, /]\n], 2]").at(1));
+    EXPECT_FALSE(jayson::lazy_document("{\"a\": [1, /\n], \"b\": 2}").find_field("b"));
+    EXPECT_FALSE(jayson::lazy_document("[[1, /").at(1));
+    EXPECT_EQ(jayson::lazy_document("[[1, //]\n], 2]").at(1)->get_integer(), 2);
+    // the second slash of a comment start in the next 64-byte block
+    for (size_t padding = 60; padding < 66; ++padding) {
+        const auto spaces = std::string(padding, ' ');
+        EXPECT_EQ(jayson::lazy_document("[[" + spaces + "//]\n], 2]").at(1)->get_integer(), 2) << padding;
+        EXPECT_FALSE(jayson::lazy_document("[[" + spaces + "/ /]\n], 2]").at(1)) << padding;
+    }
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+
+#include "jayson.hpp"
+#include "jayson_fixed.hpp"
+#include "jayson_ndjson.hpp"
+
+using namespace std::literals;
+
+// Lines of {"id": i, "name": "record i", "tags": [i, true]}
+std::string generate_records(size_t count) {
+    std::string input;
+    for (size_t i = 0; i < count; ++i) {
+        const auto id = std::to_string(i);
+        input += "{\"id\": " + id + ", \"name\": \"record " + id + "\", \"tags\": [" + id + ", true]}\n";
+    }
+    return input;
+}
+
+//------------------------------------------------------------------------------
+// RECORDS
+//------------------------------------------------------------------------------
+
+TEST(ParseMany, OneDocumentPerLine) {
+    auto batch = jayson::parse_many("{\"a\": 1}\n[2, 3]\n\"four\"\n5.5\nnull");
+    ASSERT_EQ(batch.size(), 5);
+    EXPECT_EQ(batch[0]->to_object()->get_value_for("a")->to_integer()->get_integer(), 1);
+    EXPECT_EQ(batch[1]->to_array()->size(), 2);
+    EXPECT_EQ(batch[2]->to_string()->get_string(), "four");
+    EXPECT_EQ(batch[3]->to_float()->get_float(), 5.5);
+    EXPECT_EQ(batch[4]->get_type(), jayson::jayson_types::NONE);
+}
+
+TEST(ParseMany, BlankLinesAndCarriageReturns) {
+    auto batch = jayson::parse_many("\n1\r\n  \n\t\r\n2\n\n");
+    ASSERT_EQ(batch.size(), 2);
+    EXPECT_EQ(batch[0]->to_integer()->get_integer(), 1);
+    EXPECT_EQ(batch[1]->to_integer()->get_integer(), 2);
+    EXPECT_EQ(jayson::parse_many("").size(), 0);
+}
+
+TEST(ParseMany, InvalidLines) {
+    auto batch = jayson::parse_many("[1, 2\n3\n{\"a\": 1} 2\n{\"b\": [}\n4");
+    ASSERT_EQ(batch.size(), 5);
+    EXPECT_FALSE(batch[0]);
+    EXPECT_EQ(batch[1]->to_integer()->get_integer(), 3);
+    EXPECT_FALSE(batch[2]);
+    EXPECT_FALSE(batch[3]);
+    EXPECT_EQ(batch[4]->to_integer()->get_integer(), 4);
+}
+
+//------------------------------------------------------------------------------
+// THREADS
+//------------------------------------------------------------------------------
+
+TEST(ParseMany, InputOrderWithAnyThreadCount) {
+    const size_t count = 20000;
+    const auto input = generate_records(count);
+    for (unsigned threads : {0u, 1u, 2u, 3u, 8u, 64u}) {
+        auto batch = jayson::parse_many(input, threads);
+        ASSERT_EQ(batch.size(), count) << threads;
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_TRUE(batch[i]) << i;
+            const auto *record = batch[i]->to_object();
+            ASSERT_EQ(record->get_value_for("id")->to_integer()->get_integer(), i) << threads;
+            ASSERT_EQ(record->get_value_for("name")->to_string()->get_string(), "record " + std::to_string(i));
+            ASSERT_EQ(record->get_value_for("tags")->to_array()->size(), 2);
+        }
+    }
+}
+
+TEST(ParseMany, BatchSurvivesMove) {
+    const auto input = generate_records(5000);
+    auto batch = jayson::parse_many(input, 4);
+    auto moved = std::move(batch);
+    ASSERT_EQ(moved.size(), 5000);
+    EXPECT_EQ(moved[4999]->to_object()->get_value_for("id")->to_integer()->get_integer(), 4999);
+}
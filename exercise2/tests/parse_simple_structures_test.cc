@@ -451,6 +451,41 @@ TEST(ParseSimpleStructures, ObjectAPIConsistency) {
     });
 }
 
+TEST(ParseSimpleStructures, DuplicateKeysLastWins) {
+    test_parse_both(R"({"a": 1, "b": 2, "a": 3, "a": {"x": 4}})", [](auto, auto result) {
+        ASSERT_TRUE(result);
+        auto obj = result->to_object();
+        ASSERT_TRUE(obj);
+        EXPECT_EQ(obj->size(), 2);
+        EXPECT_EQ(obj->get_keys().size(), 2);
+        EXPECT_EQ(obj->get_value_for("a")->to_object()->get_value_for("x")->to_integer()->get_integer(), 4);
+        EXPECT_EQ(obj->get_value_for("b")->to_integer()->get_integer(), 2);
+    });
+}
+
+TEST(ParseSimpleStructures, LargeObjectLookup) {
+    // Large enough for the hashed lookup, with every tenth key repeated at the end
+    std::string json = "{";
+    for (int i = 0; i < 200; ++i) json += "\"key" + std::to_string(i) + "\": " + std::to_string(i) + ", ";
+    for (int i = 0; i < 200; i += 10) json += "\"key" + std::to_string(i) + "\": " + std::to_string(-i) + ", ";
+    json += "\"\": \"empty\"}";
+
+    test_parse_both(json, [](auto, auto result) {
+        ASSERT_TRUE(result);
+        auto obj = result->to_object();
+        ASSERT_TRUE(obj);
+        EXPECT_EQ(obj->size(), 201);
+        for (int i = 0; i < 200; ++i) {
+            auto value = obj->get_value_for("key" + std::to_string(i));
+            ASSERT_TRUE(value);
+            EXPECT_EQ(value->to_integer()->get_integer(), i % 10 == 0 ? -i : i);
+        }
+        EXPECT_EQ(obj->get_value_for("")->to_string()->get_string(), "empty");
+        EXPECT_FALSE(obj->get_value_for("key200"));
+        EXPECT_FALSE(obj->get_value_for("key"));
+    });
+}
+
 TEST(ParseSimpleStructures, ArrayAPIConsistency) {
     test_parse_both("[1, 2, 3]", [](auto, auto result) {
         ASSERT_TRUE(result);
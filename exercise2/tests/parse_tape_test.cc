@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <sstream>
+
+#include "jayson.hpp"
+#include "jayson_fixed.hpp"
+#include "jayson_tape.hpp"
+
+using namespace std::literals;
+
+// Compares a tape value with the element parsed from the same input, recursively
+void expect_same_value(jayson::tape_cursor value, const jayson::jayson_element *element) {
+    ASSERT_TRUE(element);
+    ASSERT_EQ(value.get_type(), element->get_type());
+    switch (element->get_type()) {
+    case jayson::jayson_types::OBJECT: {
+        auto object = element->to_object();
+        ASSERT_EQ(value.size(), object->size());
+        for (auto member = value.first_child(); !member.at_end(); member = member.next().next()) {
+            auto key = member.get_string();
+            ASSERT_TRUE(key);
+            expect_same_value(member.next(), object->get_value_for(*key));
+        }
+        break;
+    }
+    case jayson::jayson_types::ARRAY: {
+        auto array = element->to_array();
+        ASSERT_EQ(value.size(), array->size());
+        auto child = value.first_child();
+        for (auto array_element : array->get_elements()) {
+            ASSERT_FALSE(child.at_end());
+            expect_same_value(child, array_element);
+            child = child.next();
+        }
+        EXPECT_TRUE(child.at_end());
+        break;
+    }
+    case jayson::jayson_types::STRING:
+        EXPECT_EQ(value.get_string(), element->to_string()->get_string());
+        break;
+    case jayson::jayson_types::INTEGER:
+        EXPECT_EQ(value.get_integer(), element->to_integer()->get_integer());
+        break;
+    case jayson::jayson_types::FLOAT:
+        EXPECT_EQ(value.get_float(), element->to_float()->get_float());
+        break;
+    case jayson::jayson_types::BOOLEAN:
+        EXPECT_EQ(value.get_boolean(), element->to_boolean()->get_boolean());
+        break;
+    case jayson::jayson_types::NONE:
+        break;
+    }
+}
+
+//------------------------------------------------------------------------------
+// TAPE LAYOUT
+//------------------------------------------------------------------------------
+
+TEST(ParseTape, SingleValues) {
+    EXPECT_EQ(jayson::parse_to_tape("42")->root().get_integer(), 42);
+    EXPECT_EQ(jayson::parse_to_tape("-1.5")->root().get_float(), -1.5);
+    EXPECT_EQ(jayson::parse_to_tape("\"text\"")->root().get_string(), "text");
+    EXPECT_EQ(jayson::parse_to_tape("true")->root().get_boolean(), true);
+    EXPECT_EQ(jayson::parse_to_tape("false")->root().get_boolean(), false);
+    EXPECT_EQ(jayson::parse_to_tape("null")->root().get_type(), jayson::jayson_types::NONE);
+
+    auto number = jayson::parse_to_tape("7");
+    EXPECT_FALSE(number->root().get_string());
+    EXPECT_FALSE(number->root().size());
+}
+
+TEST(ParseTape, Layout) {
+    const auto input = R"([1, {"ab": true}, "c"])"sv;
+    auto document = jayson::parse_to_tape(input);
+    ASSERT_TRUE(document);
+
+    auto word = [](jayson::tape_tag tag, std::uint64_t payload) {
+        return static_cast<std::uint64_t>(tag) << jayson::tape::tag_shift | payload;
+    };
+    const std::vector<std::uint64_t> expected = {
+        word(jayson::tape_tag::ARRAY_BEGIN, 3ull << 32 | 11),
+        word(jayson::tape_tag::INTEGER, 0), 1,
+        word(jayson::tape_tag::OBJECT_BEGIN, 1ull << 32 | 8),
+        word(jayson::tape_tag::STRING, input.find("ab")), 2,
+        word(jayson::tape_tag::TRUE, 0),
+        word(jayson::tape_tag::OBJECT_END, 3),
+        word(jayson::tape_tag::STRING, input.find('c')), 1,
+        word(jayson::tape_tag::ARRAY_END, 0),
+    };
+    EXPECT_EQ(document->words(), expected);
+}
+
+TEST(ParseTape, EmptyContainers) {
+    auto document = jayson::parse_to_tape("[[], {}]");
+    ASSERT_TRUE(document);
+    auto root = document->root();
+    EXPECT_EQ(root.size(), 2);
+    EXPECT_TRUE(root.get_value_at(0)->first_child().at_end());
+    EXPECT_EQ(root.get_value_at(0)->size(), 0);
+    EXPECT_TRUE(root.get_value_at(1)->first_child().at_end());
+    EXPECT_EQ(root.get_value_at(1)->get_type(), jayson::jayson_types::OBJECT);
+    EXPECT_FALSE(root.get_value_at(2));
+    EXPECT_FALSE(root.get_value_at(-1));
+}
+
+//------------------------------------------------------------------------------
+// NAVIGATION
+//------------------------------------------------------------------------------
+
+TEST(ParseTape, NextSkipsWholeContainers) {
+    auto document = jayson::parse_to_tape(R"({"skipped": [[1, 2], {"deep": [3]}],)"
+                                           "\n// comment\n"
+                                           R"("after": "here"})");
+    ASSERT_TRUE(document);
+    auto root = document->root();
+    ASSERT_EQ(root.size(), 2);
+
+    auto skipped = root.first_child().next();
+    EXPECT_EQ(skipped.get_type(), jayson::jayson_types::ARRAY);
+    auto after = skipped.next();
+    EXPECT_EQ(after.get_string(), "after");
+    EXPECT_EQ(after.next().get_string(), "here");
+    EXPECT_TRUE(after.next().next().at_end());
+
+    EXPECT_EQ(root.get_value_for("after")->get_string(), "here");
+    EXPECT_EQ(root.get_value_for("skipped")->get_value_at(1)->get_value_for("deep")->get_value_at(0)->get_integer(), 3);
+    EXPECT_FALSE(root.get_value_for("missing"));
+    EXPECT_FALSE(root.get_value_at(0));
+}
+
+TEST(ParseTape, DuplicateKeysLastWins) {
+    auto document = jayson::parse_to_tape(R"({"key": 1, "key": 2})");
+    ASSERT_TRUE(document);
+    EXPECT_EQ(document->root().get_value_for("key")->get_integer(), 2);
+}
+
+TEST(ParseTape, MatchesElementTree) {
+    std::ifstream t("tests/red-dress.jayson");
+    std::stringstream buffer;
+    buffer << t.rdbuf();
+    auto input = buffer.str();
+
+    auto document = jayson::parse_to_tape(input);
+    ASSERT_TRUE(document);
+    auto tree = jayson::parse_direct(input);
+    expect_same_value(document->root(), tree.get());
+}
+
+//------------------------------------------------------------------------------
+// INVALID INPUT
+//------------------------------------------------------------------------------
+
+TEST(ParseTape, InvalidInput) {
+    EXPECT_FALSE(jayson::parse_to_tape(""));
+    EXPECT_FALSE(jayson::parse_to_tape("[1, 2"));
+    EXPECT_FALSE(jayson::parse_to_tape("[1 2]"));
+    EXPECT_FALSE(jayson::parse_to_tape("{\"a\" 1}"));
+    EXPECT_FALSE(jayson::parse_to_tape("{1: 2}"));
+    EXPECT_FALSE(jayson::parse_to_tape("{\"a\": 1,}"));
+    EXPECT_FALSE(jayson::parse_to_tape("1 2"));
+    EXPECT_FALSE(jayson::parse_to_tape("]"));
+}
@@ -5,6 +5,7 @@
 #include <vector>
 #include <iostream>
 #include <cmath>
+#include <limits>
 
 #include "jayson.hpp"
 #include "jayson_fixed.hpp"
@@ -177,6 +178,35 @@ TEST(TokenizerTest, NumberEdgeCases) {
     check_integer_token(tokens.at(1), 0);
 }
 
+// Test the limits of 64-bit integers and out-of-range numbers
+TEST(TokenizerTest, IntegerLimits) {
+    auto tokens = tokenize_all("9223372036854775807 -9223372036854775808 00000000000000000000042 12345678 123456789012345678");
+    ASSERT_EQ(tokens.size(), 5);
+
+    check_integer_token(tokens.at(0), std::numeric_limits<jayson::integer_type>::max());
+    check_integer_token(tokens.at(1), std::numeric_limits<jayson::integer_type>::min());
+    check_integer_token(tokens.at(2), 42);
+    check_integer_token(tokens.at(3), 12345678);
+    check_integer_token(tokens.at(4), 123456789012345678);
+
+    for (const auto *input : {"9223372036854775808", "-9223372036854775809", "100000000000000000000", "1e400", "-1e400"}) {
+        auto tokenizer = jayson::tokenize(input);
+        EXPECT_FALSE(tokenizer.get_next_token().has_value()) << "Failed on input: " << input;
+    }
+}
+
+// Test that a number ending the input is not read past its end
+TEST(TokenizerTest, NumberAtEndOfInput) {
+    std::string_view input = "[12345678901]";
+    auto tokens = tokenize_all(input.substr(1, 11));
+    ASSERT_EQ(tokens.size(), 1);
+    check_integer_token(tokens.at(0), 12345678901);
+
+    tokens = tokenize_all(input.substr(1, 5));
+    ASSERT_EQ(tokens.size(), 1);
+    check_integer_token(tokens.at(0), 12345);
+}
+
 // Test complex JSON
 TEST(TokenizerTest, ComplexJSON) {
     std::string json = R"({
@@ -505,3 +535,57 @@ TEST(TokenizerTest, IntegerFloatBoundary) {
     ASSERT_EQ(tokens.size(), 1);
     EXPECT_EQ(tokens.at(0).get_type(), jayson::token_type::FLOAT);
 }
+
+// Test strings of many lengths at every offset within a block, closed and unclosed
+TEST(TokenizerTest, StringsAcrossBlocks) {
+    for (size_t offset = 0; offset < 70; offset++) {
+        for (size_t length = 0; length < 200; length++) {
+            std::string body(length, 'x');
+            std::string input = std::string(offset, ' ') + "\"" + body + "\" 1";
+            auto tokens = tokenize_all(input);
+            ASSERT_EQ(tokens.size(), 2) << "offset " << offset << ", length " << length;
+            check_string_token(tokens.at(0), body);
+            check_integer_token(tokens.at(1), 1);
+
+            auto tokenizer = jayson::tokenize(std::string_view(input).substr(0, input.size() - 3));
+            EXPECT_FALSE(tokenizer.get_next_token().has_value()) << "offset " << offset << ", length " << length;
+        }
+    }
+}
+
+// Test that peeks are cached and that skipping after a peek advances past the peeked token
+TEST(TokenizerTest, PeekCacheAndSkip) {
+    auto tokenizer = jayson::tokenize(R"([ "a" , 12 ] // end)");
+
+    tokenizer.skip_next_token();
+    const auto peeked = tokenizer.peek_next_token();
+    ASSERT_TRUE(peeked.has_value());
+    check_string_token(peeked.value(), "a");
+    const auto peeked_again = tokenizer.peek_next_token();
+    ASSERT_TRUE(peeked_again.has_value());
+    EXPECT_EQ(peeked_again.value().get_original().data(), peeked.value().get_original().data());
+
+    auto copy = tokenizer;
+    auto got = tokenizer.get_next_token();
+    ASSERT_TRUE(got.has_value());
+    check_string_token(got.value(), "a");
+    auto copied = copy.get_next_token();
+    ASSERT_TRUE(copied.has_value());
+    check_string_token(copied.value(), "a");
+
+    ASSERT_TRUE(tokenizer.peek_next_token().has_value());
+    check_token_type(tokenizer.peek_next_token().value(), jayson::token_type::COMMA);
+    tokenizer.skip_next_token();
+    auto number = tokenizer.get_next_token();
+    ASSERT_TRUE(number.has_value());
+    check_integer_token(number.value(), 12);
+    tokenizer.skip_next_token();
+    ASSERT_TRUE(tokenizer.peek_next_token().has_value());
+    check_token_type(tokenizer.peek_next_token().value(), jayson::token_type::COMMENT);
+    tokenizer.skip_next_token();
+    EXPECT_FALSE(tokenizer.peek_next_token().has_value());
+    tokenizer.skip_next_token();
+    EXPECT_FALSE(tokenizer.get_next_token().has_value());
+    //Peeked tokens are values, later peeks do not change them.
+    check_string_token(peeked.value(), "a");
+}